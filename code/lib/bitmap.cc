@@ -98,22 +98,112 @@ Bitmap::Test(int which) const
     }
 }
 
+//----------------------------------------------------------------------
+// LowestBitSet
+// 	Return the position of the lowest bit set in a (non-zero) word.
+//	Skips a byte at a time, so it takes at most a dozen steps.
+//----------------------------------------------------------------------
+
+static int
+LowestBitSet(unsigned int word)
+{
+    int bit = 0;
+
+    ASSERT(word != 0);
+    while ((word & 0xff) == 0) {
+	word >>= BitsInByte;
+	bit += BitsInByte;
+    }
+    while ((word & 1) == 0) {
+	word >>= 1;
+	bit++;
+    }
+    return bit;
+}
+
 //----------------------------------------------------------------------
 // Bitmap::FindAndSet
 // 	Return the number of the first bit which is clear.
 //	As a side effect, set the bit (mark it as in use).
 //	(In other words, find and allocate a bit.)
 //
-//	If no bits are clear, return -1.
+//	Skips a whole word of set bits at a time.  If no bits are clear,
+//	return -1.
 //----------------------------------------------------------------------
 
 int 
 Bitmap::FindAndSet() 
 {
-    for (int i = 0; i < numBits; i++) {
-	if (!Test(i)) {
-	    Mark(i);
-	    return i;
+    for (int i = 0; i < numWords; i++) {
+	if (map[i] != ~0u) {
+	    int which = i * BitsInWord + LowestBitSet(~map[i]);
+
+	    if (which >= numBits) {	// only the unused bits past
+		return -1;		// the end are clear
+	    }
+	    Mark(which);
+	    return which;
+	}
+    }
+    return -1;
+}
+
+//----------------------------------------------------------------------
+// Bitmap::FindAndSetRange
+// 	Return the number of the first of "count" clear bits in a row,
+//	and set them all.  If there is no such run, return -1.
+//
+//	Steps over a word at a time where the word is all set, or all
+//	clear, and a bit at a time elsewhere.
+//----------------------------------------------------------------------
+
+int
+Bitmap::FindAndSetRange(int count)
+{
+    int first = 0;		// the run of clear bits is [first, i)
+    int i = 0;
+
+    ASSERT(count > 0);
+    while (i < numBits && i - first < count) {
+	unsigned int word = map[i / BitsInWord];
+
+	if (i % BitsInWord == 0 && word == ~0u) {
+	    i += BitsInWord;
+	    first = i;
+	} else if (i % BitsInWord == 0 && word == 0) {
+	    i += BitsInWord;
+	} else if (Test(i)) {
+	    i++;
+	    first = i;
+	} else {
+	    i++;
+	}
+    }
+    if (i > numBits) {		// the last word ran past the end
+	i = numBits;
+    }
+    if (i - first < count) {
+	return -1;
+    }
+    for (i = first; i < first + count; i++) {
+	Mark(i);
+    }
+    return first;
+}
+
+//----------------------------------------------------------------------
+// Bitmap::FindFirstSet
+// 	Return the number of the first bit which is set, or -1 if 
+//	every bit is clear.  Looks at a whole word of the bitmap
+//	at a time, so for a small bitmap this is constant time.
+//----------------------------------------------------------------------
+
+int 
+Bitmap::FindFirstSet() const
+{
+    for (int i = 0; i < numWords; i++) {
+	if (map[i] != 0) {
+	    return i * BitsInWord + LowestBitSet(map[i]);
 	}
     }
     return -1;
@@ -123,19 +213,20 @@ Bitmap::FindAndSet()
 // Bitmap::NumClear
 // 	Return the number of clear bits in the bitmap.
 //	(In other words, how many bits are unallocated?)
+//	Counts the set bits, a word at a time, skipping clear ones.
 //----------------------------------------------------------------------
 
 int 
 Bitmap::NumClear() const
 {
-    int count = 0;
+    int numSet = 0;
 
-    for (int i = 0; i < numBits; i++) {
-	if (!Test(i)) {
-	    count++;
-	}
+    for (int i = 0; i < numWords; i++) {
+	for (unsigned int word = map[i]; word != 0; word &= word - 1) {
+	    numSet++;		// one per set bit; the bits past
+	}			// the end are never set
     }
-    return count;
+    return numBits - numSet;
 }
 
 //----------------------------------------------------------------------
@@ -172,14 +263,25 @@ Bitmap::SelfTest()
     ASSERT(numBits >= BitsInWord);	// bitmap must be big enough
 
     ASSERT(NumClear() == numBits);	// bitmap must be empty
+    ASSERT(FindFirstSet() == -1);
+    Mark(numBits - 1);
+    ASSERT(FindFirstSet() == numBits - 1);
+    Clear(numBits - 1);
     ASSERT(FindAndSet() == 0);
     Mark(31);
     ASSERT(Test(0) && Test(31));
+    ASSERT(FindFirstSet() == 0);
 
     ASSERT(FindAndSet() == 1);
-    Clear(0);
-    Clear(1);
-    Clear(31);
+    ASSERT(NumClear() == numBits - 3);
+    ASSERT(FindAndSetRange(29) == 2);	// just fits before bit 31
+    ASSERT(FindAndSet() == BitsInWord);	// skips the full word
+    if (numBits >= 3 * BitsInWord) {
+	ASSERT(FindAndSetRange(BitsInWord) == BitsInWord + 1);
+    }
+    for (i = 0; i < numBits; i++) {
+        Clear(i);
+    }
 
     for (i = 0; i < numBits; i++) {
         Mark(i);
@@ -42,6 +42,12 @@ class Bitmap {
     int FindAndSet();         // Return the # of a clear bit, and as a side
 				// effect, set the bit. 
 				// If no bits are clear, return -1.
+    int FindAndSetRange(int count);
+				// Return the # of the first of "count"
+				// clear bits in a row, and set them all.
+				// If there are no such bits, return -1.
+    int FindFirstSet() const;	// Return the # of the lowest set bit,
+				// or -1 if no bits are set.
     int NumClear() const;	// Return the number of clear bits
 
     void Print() const;		// Print contents of bitmap
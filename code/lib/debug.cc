@@ -24,22 +24,12 @@
 
 Debug::Debug(char *flagList)
 {
-    enableFlags = flagList;
-}
-
+    bool all = (flagList != NULL) && (strchr(flagList, dbgAll) != 0);
 
-//----------------------------------------------------------------------
-// Debug::IsEnabled
-//      Return TRUE if DEBUG messages with "flag" are to be printed.
-//----------------------------------------------------------------------
-
-bool
-Debug::IsEnabled(char flag)
-{
-    if (enableFlags != NULL) {
-	return ((strchr(enableFlags, flag) != 0) 
-		|| (strchr(enableFlags, '+') != 0));
-    } else {
-    	return FALSE;
+    for (int i = 0; i < 256; i++) {
+	enabled[i] = all;
+    }
+    for (char *flag = flagList; flag != NULL && *flag != '\0'; flag++) {
+	enabled[(unsigned char) *flag] = TRUE;
     }
 }
@@ -36,10 +36,15 @@ class Debug {
   public:
     Debug(char *flagList);
 
-    bool IsEnabled(char flag);
+    bool IsEnabled(char flag) { return enabled[(unsigned char) flag]; }
+				// Return TRUE if DEBUG messages with
+				// "flag" are to be printed
 
   private:
-    char *enableFlags;		// controls which DEBUG messages are printed
+    bool enabled[256];		// enabled[flag] controls whether DEBUG
+				// messages with flag are printed; looked
+				// up, as it is asked for on every
+				// simulated instruction
 };
 
 extern Debug *debug;
@@ -69,6 +74,20 @@ extern Debug *debug;
         Abort();                                                              \
     }
 
+//----------------------------------------------------------------------
+// SLOW_ASSERT
+//      An ASSERT whose condition takes time proportional to the size
+//	of a data structure -- "is this item on the list?" -- rather
+//	than constant time.  These are only checked if Nachos is
+//	compiled with -DSLOW_ASSERTS (see the Makefile); otherwise the
+//	condition is not even evaluated.
+//----------------------------------------------------------------------
+#ifdef SLOW_ASSERTS
+#define SLOW_ASSERT(condition)	ASSERT(condition)
+#else
+#define SLOW_ASSERT(condition)
+#endif
+
 //----------------------------------------------------------------------
 // ASSERTNOTREACHED
 //      Print a message and dump core (equivalent to ASSERT(FALSE) without
@@ -0,0 +1,393 @@
+// heap.cc
+//     	Routines to manage an indexed 4-ary heap of "things".
+//	Heaps are implemented as templates so that we can store
+//	anything on the heap in a type-safe manner.
+//
+//	The heap is kept in an array that doubles in size when it
+//	fills up, so in the steady state Insert and Remove do no
+//	allocation at all.
+//
+//     	NOTE: Mutual exclusion must be provided by the caller.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+
+const int HeapInitialSlots = 16;	// initial size of the heap array
+const int HeapArity = 4;		// children of each element; the
+					// children of heap[i] are
+					// heap[HeapArity * i + 1] on
+
+//----------------------------------------------------------------------
+// Heap<T>::Heap
+//	Initialize a heap, empty to start with.
+//	Elements can now be added to the heap.
+//
+//	"comp" orders the items on the heap
+//	"handle" returns where, in an item, to keep its heap index
+//----------------------------------------------------------------------
+
+template <class T>
+Heap<T>::Heap(int (*comp)(T x, T y), int *(*handle)(T x))
+{
+    compare = comp;
+    handleOf = handle;
+    numSlots = HeapInitialSlots;
+    heap = new HeapElement<T>[numSlots];
+    numInList = 0;
+    nextSeq = 0;
+}
+
+//----------------------------------------------------------------------
+// Heap<T>::~Heap
+//	Prepare a heap for deallocation.
+//      This does *NOT* free the items on the heap.
+//      Normally, the heap should be empty when this is called.
+//----------------------------------------------------------------------
+
+template <class T>
+Heap<T>::~Heap()
+{
+    delete [] heap;
+}
+
+//----------------------------------------------------------------------
+// Heap<T>::Less
+//	Return TRUE if "x" should come off the heap before "y".
+//	Items that compare equal are ordered by insertion.
+//----------------------------------------------------------------------
+
+template <class T>
+bool
+Heap<T>::Less(const HeapElement<T> &x, const HeapElement<T> &y) const
+{
+    int c = compare(x.item, y.item);
+
+    if (c != 0) {
+	return c < 0;
+    }
+    return x.seq < y.seq;
+}
+
+//----------------------------------------------------------------------
+// Heap<T>::Place
+//	Store "element" in slot "i" of the heap array, and record the
+//	slot in the item's handle.
+//----------------------------------------------------------------------
+
+template <class T>
+void
+Heap<T>::Place(int i, const HeapElement<T> &element)
+{
+    heap[i] = element;
+    *handleOf(element.item) = i;
+}
+
+//----------------------------------------------------------------------
+// Heap<T>::SiftUp
+//	Move the element in slot "i" towards the front of the heap,
+//	until its parent comes before it.
+//----------------------------------------------------------------------
+
+template <class T>
+void
+Heap<T>::SiftUp(int i)
+{
+    HeapElement<T> element = heap[i];
+
+    while (i > 0) {
+	int parent = (i - 1) / HeapArity;
+
+	if (!Less(element, heap[parent])) {
+	    break;
+	}
+	Place(i, heap[parent]);
+	i = parent;
+    }
+    Place(i, element);
+}
+
+//----------------------------------------------------------------------
+// Heap<T>::SiftDown
+//	Move the element in slot "i" towards the back of the heap,
+//	until it comes before all of its children.
+//----------------------------------------------------------------------
+
+template <class T>
+void
+Heap<T>::SiftDown(int i)
+{
+    HeapElement<T> element = heap[i];
+
+    for (;;) {
+	int first = HeapArity * i + 1;
+	int end = first + HeapArity;
+	int child = first;
+
+	if (first >= numInList) {
+	    break;
+	}
+	if (end > numInList) {
+	    end = numInList;
+	}
+	for (int c = first + 1; c < end; c++) {	// pick the smallest child
+	    if (Less(heap[c], heap[child])) {
+		child = c;
+	    }
+	}
+	if (!Less(heap[child], element)) {
+	    break;
+	}
+	Place(i, heap[child]);
+	i = child;
+    }
+    Place(i, element);
+}
+
+//----------------------------------------------------------------------
+// Heap<T>::Fix
+//	The element in slot "i" may be out of place, either way; move
+//	it to where it belongs.
+//----------------------------------------------------------------------
+
+template <class T>
+void
+Heap<T>::Fix(int i)
+{
+    if (i > 0 && Less(heap[i], heap[(i - 1) / HeapArity])) {
+	SiftUp(i);
+    } else {
+	SiftDown(i);
+    }
+}
+
+//----------------------------------------------------------------------
+// Heap<T>::Insert
+//      Insert an "item" onto the heap, so that it comes out after
+//	every item that is smaller than it, or equal to it.
+//
+//	Grows the heap array if it is full.
+//
+//	"item" is the thing to put on the heap.
+//----------------------------------------------------------------------
+
+template <class T>
+void
+Heap<T>::Insert(T item)
+{
+    HeapElement<T> element;
+
+    ASSERT(!IsInList(item));
+    if (numInList == numSlots) {	// out of room, double the array
+	HeapElement<T> *bigger = new HeapElement<T>[numSlots * 2];
+
+	for (int i = 0; i < numInList; i++) {
+	    bigger[i] = heap[i];
+	}
+	delete [] heap;
+	heap = bigger;
+	numSlots *= 2;
+    }
+    element.item = item;
+    element.seq = nextSeq++;
+    Place(numInList, element);
+    numInList++;
+    SiftUp(numInList - 1);
+    ASSERT(IsInList(item));
+}
+
+//----------------------------------------------------------------------
+// Heap<T>::RemoveFront
+//      Remove the smallest "item" from the front of the heap.
+//	Heap must not be empty.
+//
+// Returns:
+//	The removed item.
+//----------------------------------------------------------------------
+
+template <class T>
+T
+Heap<T>::RemoveFront()
+{
+    T thing;
+
+    ASSERT(!IsEmpty());
+    thing = heap[0].item;
+    Remove(thing);
+    return thing;
+}
+
+//----------------------------------------------------------------------
+// Heap<T>::Remove
+//      Remove a specific item from the heap.  Must be on the heap!
+//	The item's handle tells us where it is, so there is no search;
+//	the last element is moved into the hole and sifted into place.
+//----------------------------------------------------------------------
+
+template <class T>
+void
+Heap<T>::Remove(T item)
+{
+    int i = *handleOf(item);
+
+    ASSERT(i >= 0 && i < numInList && heap[i].item == item);
+
+    numInList--;
+    if (i != numInList) {		// fill the hole with the last element
+	Place(i, heap[numInList]);
+	Fix(i);
+    }
+    *handleOf(item) = -1;
+    ASSERT(!IsInList(item));
+}
+
+//----------------------------------------------------------------------
+// Heap<T>::Update
+//      The key of "item", which must be on the heap, has changed.
+//	Move it to where it now belongs.
+//
+//	This has the same effect as Remove followed by Insert: among
+//	the items it now compares equal to, "item" goes to the back.
+//----------------------------------------------------------------------
+
+template <class T>
+void
+Heap<T>::Update(T item)
+{
+    int i = *handleOf(item);
+
+    ASSERT(i >= 0 && i < numInList && heap[i].item == item);
+
+    heap[i].seq = nextSeq++;
+    Fix(i);
+}
+
+//----------------------------------------------------------------------
+// Heap<T>::IsInList
+//      Return TRUE if the item is on this heap.  The handle says
+//	where to look, so there is no search.
+//----------------------------------------------------------------------
+
+template <class T>
+bool
+Heap<T>::IsInList(T item) const
+{
+    int i = *handleOf(item);
+
+    return (i >= 0 && i < numInList && heap[i].item == item);
+}
+
+//----------------------------------------------------------------------
+// Heap<T>::Apply
+//      Apply function to every item on the heap, in heap order.
+//
+//	"func" -- the function to apply
+//----------------------------------------------------------------------
+
+template <class T>
+void
+Heap<T>::Apply(void (*func)(T)) const
+{
+    for (int i = 0; i < numInList; i++) {
+	(*func)(heap[i].item);
+    }
+}
+
+//----------------------------------------------------------------------
+// Heap<T>::ApplySorted
+//      Apply function to every item on the heap, in the order they
+//	would come off it.  Sorts a copy of the heap, so the heap is
+//	left alone; meant for printing, not for the common case.
+//
+//	"func" -- the function to apply
+//----------------------------------------------------------------------
+
+template <class T>
+void
+Heap<T>::ApplySorted(void (*func)(T)) const
+{
+    HeapElement<T> *sorted = new HeapElement<T>[numInList + 1];
+    int i, j;
+
+    for (i = 0; i < numInList; i++) {	// insertion sort; heaps we
+	HeapElement<T> element = heap[i];	// print are small
+
+	for (j = i; j > 0 && Less(element, sorted[j - 1]); j--) {
+	    sorted[j] = sorted[j - 1];
+	}
+	sorted[j] = element;
+    }
+    for (i = 0; i < numInList; i++) {
+	(*func)(sorted[i].item);
+    }
+    delete [] sorted;
+}
+
+//----------------------------------------------------------------------
+// Heap<T>::SanityCheck
+//      Test whether this is still a legal heap.
+//
+//	Tests: does every element come after its parent?
+//	       does every item know where it is?
+//----------------------------------------------------------------------
+
+template <class T>
+void
+Heap<T>::SanityCheck() const
+{
+    ASSERT(numInList >= 0 && numInList <= numSlots);
+    for (int i = 0; i < numInList; i++) {
+	ASSERT(*handleOf(heap[i].item) == i);
+	if (i > 0) {
+	    ASSERT(!Less(heap[i], heap[(i - 1) / HeapArity]));
+	}
+    }
+}
+
+//----------------------------------------------------------------------
+// Heap<T>::SelfTest
+//      Test whether this module is working.
+//----------------------------------------------------------------------
+
+template <class T>
+void
+Heap<T>::SelfTest(T *p, int numEntries)
+{
+    int i;
+    T *q = new T[numEntries];
+
+    SanityCheck();
+    ASSERT(IsEmpty());
+
+    for (i = 0; i < numEntries; i++) {
+	Insert(p[i]);
+	ASSERT(IsInList(p[i]));
+	ASSERT(!IsEmpty());
+    }
+    SanityCheck();
+
+    // should be able to take out anything we put in, by handle
+    Remove(p[0]);
+    ASSERT(!IsInList(p[0]));
+    SanityCheck();
+    Insert(p[0]);
+    Update(p[numEntries - 1]);
+    SanityCheck();
+
+    // should be able to get out everything we put in, in order
+    for (i = 0; i < numEntries; i++) {
+	q[i] = RemoveFront();
+	ASSERT(!IsInList(q[i]));
+	SanityCheck();
+    }
+    ASSERT(IsEmpty());
+
+    // make sure everything came out in the right order
+    for (i = 0; i < (numEntries - 1); i++) {
+	ASSERT(compare(q[i], q[i + 1]) <= 0);
+    }
+
+    delete [] q;
+}
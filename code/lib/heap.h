@@ -0,0 +1,123 @@
+// heap.h
+//	Data structures to manage an indexed priority queue (4-ary heap).
+//
+//	Like a SortedList, a Heap keeps its items ordered by a "Compare"
+//	function, so that RemoveFront always returns the smallest item.
+//	Unlike a SortedList, insertion is O(log n) instead of an O(n)
+//	walk, and no element is allocated per insertion.
+//
+//	The heap is "indexed" (intrusive): every item carries a handle,
+//	an integer slot inside the item itself, that the heap keeps up
+//	to date with the item's position in the heap array.  This makes
+//	"is it in the heap" O(1), and lets us remove an item, or restore
+//	the ordering after its key has changed, in O(log n) without
+//	searching for it.  An item not in any heap has a handle of -1.
+//	Several heaps may share a handle, as long as an item is on at
+//	most one of them at a time.
+//
+//	Items that compare equal come out in the order they were put
+//	in, exactly as with SortedList::Insert, so a Heap can replace
+//	a SortedList without changing the order in which things happen.
+//
+//	Each element has four children rather than two: the heap is
+//	half as deep, so Insert (the common case, for timers and ready
+//	threads) moves an element past half as many parents, at the
+//	cost of comparing more children on the way down.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef HEAP_H
+#define HEAP_H
+
+#include "copyright.h"
+#include "debug.h"
+
+// The following class defines a "heap element" -- the item, plus
+// the sequence number it was inserted with, used to break ties
+// between items that compare equal.
+//
+// This class is private to this module.  Made public for notational
+// convenience.
+
+template <class T>
+class HeapElement {
+  public:
+    T item;			// item on the heap
+    unsigned int seq;		// insertion order, for ties
+};
+
+// The following class defines a "heap" -- an array of heap elements
+// arranged so that the smallest element is always at the front.
+// All types to be put on a heap must have a "Compare" function
+// defined, with the same meaning as for SortedList:
+//	   int Compare(T x, T y)
+//		returns -1 if x < y
+//		returns 0 if x == y
+//		returns 1 if x > y
+// and a "Handle" function returning the address of the integer
+// slot, inside the item, that the heap uses to remember where the
+// item is:
+//	   int *Handle(T x)
+
+template <class T>
+class Heap {
+  public:
+    Heap(int (*comp)(T x, T y), int *(*handle)(T x));
+    				// initialize the heap
+    ~Heap();			// de-allocate the heap
+
+    void Insert(T item);	// put an item on the heap in sorted order
+
+    T Front() { ASSERT(!IsEmpty()); return heap[0].item; }
+    				// Return smallest item on heap
+				// without removing it
+    T RemoveFront(); 		// Take smallest item off the heap
+    void Remove(T item); 	// Remove specific item from heap
+    void Update(T item);	// the key of "item" has changed;
+				// restore the heap ordering
+
+    bool IsInList(T item) const;// is the item on this heap?
+
+    unsigned int NumInList() { return numInList; }
+    				// how many items on the heap?
+    bool IsEmpty() { return (numInList == 0); }
+    				// is the heap empty?
+    T Item(int i) { ASSERT(i >= 0 && i < numInList); return heap[i].item; }
+    				// the i'th item, in heap (not sorted)
+				// order -- for iterating over the heap
+
+    void Apply(void (*f)(T)) const;
+    				// apply function to all elements on heap,
+				// in heap (not sorted) order
+    void ApplySorted(void (*f)(T)) const;
+				// same, in the order they would come
+				// off the heap; slow, for debugging
+
+    void SanityCheck() const;	// has this heap been corrupted?
+    void SelfTest(T *p, int numEntries);
+				// verify module is working
+
+  private:
+    int (*compare)(T x, T y);	// function for ordering heap elements
+    int *(*handleOf)(T x);	// where the item keeps its heap index
+
+    HeapElement<T> *heap;	// the heap array, heap[0] is smallest
+    int numInList;		// number of elements on the heap
+    int numSlots;		// number of elements the array can hold
+    unsigned int nextSeq;	// sequence number for the next Insert
+
+    bool Less(const HeapElement<T> &x, const HeapElement<T> &y) const;
+				// does x come out before y?
+    void Place(int i, const HeapElement<T> &element);
+				// store element in slot i, and tell it so
+    void SiftUp(int i);		// move heap[i] towards the front
+    void SiftDown(int i);	// move heap[i] towards the back
+    void Fix(int i);		// move heap[i] whichever way it belongs
+};
+
+#include "heap.cc"		// templates are really like macros
+				// so needs to be included in every
+				// file that uses the template
+#endif // HEAP_H
@@ -0,0 +1,276 @@
+// intrusivelist.cc
+//	Routines to manage doubly linked lists of "things" that carry
+//	their own links (see intrusivelist.h).
+//
+//     	NOTE: Mutual exclusion must be provided by the caller.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+
+//----------------------------------------------------------------------
+// IntrusiveList<T,hook>::IntrusiveList
+//	Initialize a list, empty to start with.
+//----------------------------------------------------------------------
+
+template <class T, ListHook<T> T::*hook>
+IntrusiveList<T, hook>::IntrusiveList()
+{
+    first = last = NULL;
+    numInList = 0;
+}
+
+//----------------------------------------------------------------------
+// IntrusiveList<T,hook>::~IntrusiveList
+//	Prepare a list for deallocation.  Normally the list is empty;
+//	if not, the items still on it are taken off, so they can go on
+//	another list.  The items themselves are not freed.
+//----------------------------------------------------------------------
+
+template <class T, ListHook<T> T::*hook>
+IntrusiveList<T, hook>::~IntrusiveList()
+{
+    while (!IsEmpty()) {
+	(void) RemoveFront();
+    }
+}
+
+//----------------------------------------------------------------------
+// IntrusiveList<T,hook>::InsertBefore
+//	Link "item", which must not be on a list, in just ahead of
+//	"before", which must be on this one.  If "before" is NULL, put
+//	"item" at the end.
+//----------------------------------------------------------------------
+
+template <class T, ListHook<T> T::*hook>
+void
+IntrusiveList<T, hook>::InsertBefore(T *item, T *before)
+{
+    ListHook<T> *links = &(item->*hook);
+
+    ASSERT(links->list == NULL);	// on one list at a time
+    links->list = this;
+    links->next = before;
+    if (before == NULL) {		// put it after last
+	links->prev = last;
+	last = item;
+    } else {
+	ASSERT(IsInList(before));
+	links->prev = (before->*hook).prev;
+	(before->*hook).prev = item;
+    }
+    if (links->prev == NULL) {		// it's the new first
+	first = item;
+    } else {
+	(links->prev->*hook).next = item;
+    }
+    numInList++;
+}
+
+//----------------------------------------------------------------------
+// IntrusiveList<T,hook>::Append
+//      Append an "item" to the end of the list.
+//----------------------------------------------------------------------
+
+template <class T, ListHook<T> T::*hook>
+void
+IntrusiveList<T, hook>::Append(T *item)
+{
+    InsertBefore(item, NULL);
+}
+
+//----------------------------------------------------------------------
+// IntrusiveList<T,hook>::Prepend
+//	Same as Append, only put "item" on the front.
+//----------------------------------------------------------------------
+
+template <class T, ListHook<T> T::*hook>
+void
+IntrusiveList<T, hook>::Prepend(T *item)
+{
+    InsertBefore(item, first);
+}
+
+//----------------------------------------------------------------------
+// IntrusiveList<T,hook>::RemoveFront
+//      Remove the first "item" from the front of the list.
+//	List must not be empty.
+//
+// Returns:
+//	The removed item.
+//----------------------------------------------------------------------
+
+template <class T, ListHook<T> T::*hook>
+T *
+IntrusiveList<T, hook>::RemoveFront()
+{
+    T *thing = first;
+
+    ASSERT(!IsEmpty());
+    Remove(thing);
+    return thing;
+}
+
+//----------------------------------------------------------------------
+// IntrusiveList<T,hook>::Remove
+//      Remove a specific item from the list.  Must be in the list!
+//	Its links say where it is, so there is no search.
+//----------------------------------------------------------------------
+
+template <class T, ListHook<T> T::*hook>
+void
+IntrusiveList<T, hook>::Remove(T *item)
+{
+    ListHook<T> *links = &(item->*hook);
+
+    ASSERT(links->list == this);
+    if (links->prev == NULL) {
+	first = links->next;
+    } else {
+	(links->prev->*hook).next = links->next;
+    }
+    if (links->next == NULL) {
+	last = links->prev;
+    } else {
+	(links->next->*hook).prev = links->prev;
+    }
+    links->next = links->prev = NULL;
+    links->list = NULL;
+    numInList--;
+}
+
+//----------------------------------------------------------------------
+// IntrusiveList<T,hook>::Apply
+//      Apply function to every item on a list.
+//
+//	"func" -- the function to apply
+//----------------------------------------------------------------------
+
+template <class T, ListHook<T> T::*hook>
+void
+IntrusiveList<T, hook>::Apply(void (*func)(T *)) const
+{
+    for (T *ptr = first; ptr != NULL; ptr = (ptr->*hook).next) {
+	(*func)(ptr);
+    }
+}
+
+//----------------------------------------------------------------------
+// IntrusiveList<T,hook>::SanityCheck
+//      Test whether this is still a legal list: the links agree in
+//	both directions, and the count is right.
+//----------------------------------------------------------------------
+
+template <class T, ListHook<T> T::*hook>
+void
+IntrusiveList<T, hook>::SanityCheck() const
+{
+    T *prev = NULL;
+    int numFound = 0;
+
+    for (T *ptr = first; ptr != NULL; prev = ptr, ptr = (ptr->*hook).next) {
+	ASSERT((ptr->*hook).list == this);
+	ASSERT((ptr->*hook).prev == prev);
+	numFound++;
+	ASSERT(numFound <= numInList);	// prevent infinite loop
+    }
+    ASSERT(numFound == numInList);
+    ASSERT(last == prev);
+}
+
+//----------------------------------------------------------------------
+// IntrusiveList<T,hook>::SelfTest
+//      Test whether this module is working.  The items in "p" must
+//	not be on any list.
+//----------------------------------------------------------------------
+
+template <class T, ListHook<T> T::*hook>
+void
+IntrusiveList<T, hook>::SelfTest(T **p, int numEntries)
+{
+    int i;
+    IntrusiveListIterator<T, hook> *iterator =
+				new IntrusiveListIterator<T, hook>(this);
+
+    SanityCheck();
+    // check various ways that list is empty
+    ASSERT(IsEmpty() && (first == NULL));
+    for (; !iterator->IsDone(); iterator->Next()) {
+	ASSERTNOTREACHED();	// nothing on list
+    }
+    delete iterator;
+
+    for (i = 0; i < numEntries; i++) {
+	Append(p[i]);
+	ASSERT(IsInList(p[i]));
+	ASSERT(!IsEmpty());
+    }
+    SanityCheck();
+
+    // the iterator sees them in order
+    iterator = new IntrusiveListIterator<T, hook>(this);
+    for (i = 0; !iterator->IsDone(); iterator->Next(), i++) {
+	ASSERT(iterator->Item() == p[i]);
+    }
+    ASSERT(i == numEntries);
+    delete iterator;
+
+    // take them out of the middle, move the last to the front, and
+    // take what is left off the front
+    for (i = 1; i < numEntries - 1; i++) {
+	Remove(p[i]);
+	ASSERT(!IsInList(p[i]));
+	SanityCheck();
+    }
+    if (numEntries > 1) {
+	Remove(p[numEntries - 1]);
+	Prepend(p[numEntries - 1]);
+	ASSERT(Front() == p[numEntries - 1]);
+	SanityCheck();
+    }
+    while (!IsEmpty()) {
+	T *item = RemoveFront();
+
+	ASSERT(!IsInList(item));
+    }
+    SanityCheck();
+}
+
+//----------------------------------------------------------------------
+// IntrusiveSortedList<T,hook>::Insert
+//      Insert an "item" into a list, so that the list elements are
+//	sorted in increasing order, after any that compare equal.
+//
+//	Walks the list to find where the item belongs; nothing is
+//	allocated.
+//----------------------------------------------------------------------
+
+template <class T, ListHook<T> T::*hook>
+void
+IntrusiveSortedList<T, hook>::Insert(T *item)
+{
+    T *ptr = this->first;
+
+    while (ptr != NULL && compare(item, ptr) >= 0) {
+	ptr = (ptr->*hook).next;
+    }
+    this->InsertBefore(item, ptr);
+}
+
+//----------------------------------------------------------------------
+// IntrusiveSortedList<T,hook>::SanityCheck
+//      Test whether this is still a legal sorted list.
+//----------------------------------------------------------------------
+
+template <class T, ListHook<T> T::*hook>
+void
+IntrusiveSortedList<T, hook>::SanityCheck() const
+{
+    IntrusiveList<T, hook>::SanityCheck();
+    for (T *ptr = this->first; ptr != NULL && (ptr->*hook).next != NULL;
+					ptr = (ptr->*hook).next) {
+	ASSERT(compare(ptr, (ptr->*hook).next) <= 0);
+    }
+}
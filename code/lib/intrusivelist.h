@@ -0,0 +1,148 @@
+// intrusivelist.h
+//	Data structures to manage doubly linked lists whose links are
+//	kept in the items themselves.
+//
+//	A List allocates a ListElement for every item put on it, and
+//	has to walk the list to find an item to remove.  An item to be
+//	put on an IntrusiveList instead has a ListHook member -- its
+//	links, and which list it is on -- named as a template parameter:
+//
+//	    class Thread {
+//		...
+//		ListHook<Thread> queueHook;
+//	    };
+//	    IntrusiveList<Thread, &Thread::queueHook> readyList;
+//
+//	So putting an item on the list, or taking it off, allocates
+//	nothing, and removing a specific item, or asking whether it is
+//	on the list, takes constant time.  The price is that an item is
+//	on at most one list per hook, and the list holds pointers to
+//	items, which must not be deleted while they are on it.
+//
+//	IntrusiveListIterator steps through a list the way ListIterator
+//	does.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef INTRUSIVELIST_H
+#define INTRUSIVELIST_H
+
+#include "copyright.h"
+#include "debug.h"
+
+// The following class defines the links an item keeps, to be on an
+// IntrusiveList.  It is owned by the list the item is on; made public
+// for notational convenience.
+
+template <class T>
+class ListHook {
+  public:
+    ListHook() { next = prev = NULL; list = NULL; }
+				// not on any list
+
+    T *next;			// next item on the list, NULL if last
+    T *prev;			// previous item, NULL if first
+    void *list;			// the list we are on, NULL if none
+};
+
+template <class T, ListHook<T> T::*hook> class IntrusiveListIterator;
+
+// The following class defines an intrusive list -- a doubly linked
+// list of items, linked through their "hook" member.
+
+template <class T, ListHook<T> T::*hook>
+class IntrusiveList {
+  public:
+    IntrusiveList();		// initialize the list
+    virtual ~IntrusiveList();	// de-allocate the list; takes any
+				// items still on it off
+
+    void Prepend(T *item);	// Put item at the beginning of the list
+    void Append(T *item);	// Put item at the end of the list
+    void InsertBefore(T *item, T *before);
+				// Put item just ahead of "before", which
+				// is on the list; NULL means at the end
+
+    T *Front() { return first; }
+				// Return first item on list without
+				// removing it; NULL if the list is empty
+    T *RemoveFront();		// Take item off the front of the list
+    void Remove(T *item);	// Remove specific item from list
+
+    bool IsInList(T *item) const { return (item->*hook).list == this; }
+				// is the item in the list?
+
+    unsigned int NumInList() { return numInList; }
+				// how many items in the list?
+    bool IsEmpty() { return numInList == 0; }
+				// is the list empty?
+
+    void Apply(void (*f)(T *)) const;
+				// apply function to all items in list
+
+    void SanityCheck() const;	// has this list been corrupted?
+    void SelfTest(T **p, int numEntries);
+				// verify module is working
+
+  protected:
+    T *first;			// Head of the list, NULL if list is empty
+    T *last;			// Last item on list
+    int numInList;		// number of items in list
+
+    friend class IntrusiveListIterator<T, hook>;
+};
+
+// The following class defines an intrusive "sorted list" -- arranged
+// so that RemoveFront always returns the smallest item.  Items that
+// compare equal come out in the order they were inserted.  The
+// comparison function has the same meaning as for a SortedList.
+
+template <class T, ListHook<T> T::*hook>
+class IntrusiveSortedList : public IntrusiveList<T, hook> {
+  public:
+    IntrusiveSortedList(int (*comp)(T *x, T *y)) { compare = comp; }
+
+    void Insert(T *item);	// insert an item onto the list in
+				// sorted order
+
+    void SanityCheck() const;	// has this list been corrupted?
+
+  private:
+    int (*compare)(T *x, T *y);	// function for sorting list items
+};
+
+// The following class can be used to step through a list, as with a
+// ListIterator.  The list must not be changed while we do.
+//
+//	IntrusiveListIterator<Thread, &Thread::queueHook> iter(list);
+//
+//	for (; !iter.IsDone(); iter.Next()) {
+//	    Operation on iter.Item()
+//	}
+
+template <class T, ListHook<T> T::*hook>
+class IntrusiveListIterator {
+  public:
+    IntrusiveListIterator(IntrusiveList<T, hook> *list)
+	{ current = list->first; }
+				// initialize an iterator
+
+    bool IsDone() { return current == NULL; }
+				// return TRUE if we are at the end of the list
+
+    T *Item() { ASSERT(!IsDone()); return current; }
+				// return current item on list
+
+    void Next() { current = (current->*hook).next; }
+				// update iterator to point to next
+
+  private:
+    T *current;			// where we are in the list
+};
+
+#include "intrusivelist.cc"	// templates are really like macros
+				// so needs to be included in every
+				// file that uses the template
+#endif // INTRUSIVELIST_H
@@ -1,6 +1,7 @@
 // libtest.cc 
 //	Driver code to call self-test routines for standard library
-//	classes -- bitmaps, lists, sorted lists, and hash tables.
+//	classes -- bitmaps, lists, sorted lists, intrusive lists, heaps,
+//	red-black trees, and hash tables.
 //
 // Copyright (c) 1992-1996 The Regents of the University of California.
 // All rights reserved.  See copyright.h for copyright notice and limitation 
@@ -10,6 +11,9 @@
 #include "libtest.h"
 #include "bitmap.h"
 #include "list.h"
+#include "intrusivelist.h"
+#include "heap.h"
+#include "rbtree.h"
 #include "hash.h"
 #include "sysdep.h"
 
@@ -53,6 +57,45 @@ HashKey(char *str) {
 // Array of values to be inserted into a List or SortedList. 
 static int listTestVector[] = { 9, 5, 7 };
 
+// Items to be put on an IntrusiveList, each with its own links.
+class ListTestItem {
+  public:
+    int key;
+    ListHook<ListTestItem> hook;
+};
+
+static ListTestItem listTestItems[4];
+static ListTestItem *listTestItemVector[] = { &listTestItems[0],
+	&listTestItems[1], &listTestItems[2], &listTestItems[3] };
+
+// Items to be inserted into a Heap.  Each item carries its own
+// heap index, which must start out as -1 (not on any heap).
+class HeapTestItem {
+  public:
+    int key;
+    int index;
+};
+
+static HeapTestItem heapTestItems[] = { {9, -1}, {5, -1}, {7, -1}, {5, -1} };
+static HeapTestItem *heapTestVector[] = { &heapTestItems[0],
+	&heapTestItems[1], &heapTestItems[2], &heapTestItems[3] };
+
+//----------------------------------------------------------------------
+// HeapItemCompare, HeapItemHandle
+//	Order two heap test items by key, and tell the Heap where an
+//	item keeps its heap index.
+//----------------------------------------------------------------------
+
+static int
+HeapItemCompare(HeapTestItem *x, HeapTestItem *y) {
+    return IntCompare(x->key, y->key);
+}
+
+static int *
+HeapItemHandle(HeapTestItem *x) {
+    return &x->index;
+}
+
 // Array of values to be inserted into the HashTable
 // There are enough here to force a ReHash().
 static char *hashTestVector[] = { "0", "1", "2", "3", "4", "5", "6",
@@ -60,8 +103,8 @@ static char *hashTestVector[] = { "0", "1", "2", "3", "4", "5", "6",
 
 //----------------------------------------------------------------------
 // LibSelfTest
-//	Run self tests on bitmaps, lists, sorted lists, and 
-//	hash tables.
+//	Run self tests on bitmaps, lists, sorted lists, intrusive lists,
+//	heaps, red-black trees, and hash tables.
 //----------------------------------------------------------------------
 
 void
@@ -69,6 +112,11 @@ LibSelfTest () {
     Bitmap *map = new Bitmap(200);
     List<int> *list = new List<int>;
     SortedList<int> *sortList = new SortedList<int>(IntCompare);
+    IntrusiveList<ListTestItem, &ListTestItem::hook> *intrusiveList =
+	new IntrusiveList<ListTestItem, &ListTestItem::hook>;
+    Heap<HeapTestItem *> *heap = 
+	new Heap<HeapTestItem *>(HeapItemCompare, HeapItemHandle);
+    RBTree<int> *tree = new RBTree<int>(IntCompare);
     HashTable<int, char *> *hashTable = 
 	new HashTable<int, char *>(HashKey, HashInt);
 	
@@ -76,10 +124,18 @@ LibSelfTest () {
     map->SelfTest();
     list->SelfTest(listTestVector, sizeof(listTestVector)/sizeof(int));
     sortList->SelfTest(listTestVector, sizeof(listTestVector)/sizeof(int));
+    intrusiveList->SelfTest(listTestItemVector,
+	sizeof(listTestItemVector)/sizeof(ListTestItem *));
+    heap->SelfTest(heapTestVector, 
+	sizeof(heapTestVector)/sizeof(HeapTestItem *));
+    tree->SelfTest(listTestVector, sizeof(listTestVector)/sizeof(int));
     hashTable->SelfTest(hashTestVector, sizeof(hashTestVector)/sizeof(char *));
 
     delete map;
     delete list;
     delete sortList;
+    delete intrusiveList;
+    delete heap;
+    delete tree;
     delete hashTable;
 }
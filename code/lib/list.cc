@@ -76,7 +76,7 @@ List<T>::Append(T item)
 {
     ListElement<T> *element = new ListElement<T>(item);
 
-    ASSERT(!IsInList(item));
+    SLOW_ASSERT(!IsInList(item));
     if (IsEmpty()) {		// list is empty
 	first = element;
 	last = element;
@@ -85,7 +85,7 @@ List<T>::Append(T item)
 	last = element;
     }
     numInList++;
-    ASSERT(IsInList(item));
+    SLOW_ASSERT(IsInList(item));
 }
 
 //----------------------------------------------------------------------
@@ -99,7 +99,7 @@ List<T>::Prepend(T item)
 {
     ListElement<T> *element = new ListElement<T>(item);
 
-    ASSERT(!IsInList(item));
+    SLOW_ASSERT(!IsInList(item));
     if (IsEmpty()) {		// list is empty
 	first = element;
 	last = element;
@@ -108,7 +108,7 @@ List<T>::Prepend(T item)
 	first = element;
     }
     numInList++;
-    ASSERT(IsInList(item));
+    SLOW_ASSERT(IsInList(item));
 }
 
 //----------------------------------------------------------------------
@@ -153,7 +153,7 @@ List<T>::Remove(T item)
     ListElement<T> *prev, *ptr;
     T removed;
 
-    ASSERT(IsInList(item));
+    SLOW_ASSERT(IsInList(item));
 
     // if first item on list is match, then remove from front
     if (item == first->item) {	
@@ -174,7 +174,7 @@ List<T>::Remove(T item)
         }
 	ASSERT(ptr != NULL);	// should always find item!
     }
-   ASSERT(!IsInList(item));
+   SLOW_ASSERT(!IsInList(item));
 }
 
 //----------------------------------------------------------------------
@@ -236,7 +236,7 @@ SortedList<T>::Insert(T item)
     ListElement<T> *element = new ListElement<T>(item);
     ListElement<T> *ptr;		// keep track
 
-    ASSERT(!IsInList(item));
+    SLOW_ASSERT(!this->IsInList(item));
     if (this->IsEmpty()) {			// if list is empty, put at front
         this->first = element;
         this->last = element;
@@ -256,7 +256,7 @@ SortedList<T>::Insert(T item)
 	this->last = element;
     }
     this->numInList++;
-    ASSERT(IsInList(item));
+    SLOW_ASSERT(this->IsInList(item));
 }
 
 //----------------------------------------------------------------------
@@ -362,14 +362,14 @@ SortedList<T>::SelfTest(T *p, int numEntries)
 
     for (i = 0; i < numEntries; i++) {
 	 Insert(p[i]);
-	 ASSERT(IsInList(p[i]));
+	 ASSERT(this->IsInList(p[i]));
      }
      SanityCheck();
 
      // should be able to get out everything we put in
      for (i = 0; i < numEntries; i++) {
 	 q[i] = this->RemoveFront();
-         ASSERT(!IsInList(q[i]));
+         ASSERT(!this->IsInList(q[i]));
      }
      ASSERT(this->IsEmpty());
 
@@ -0,0 +1,567 @@
+// rbtree.cc
+//     	Routines to manage a red-black tree of "things".
+//	Trees are implemented as templates so that we can store
+//	anything in the tree in a type-safe manner.
+//
+//	This follows the algorithms in Cormen, Leiserson, Rivest and
+//	Stein, "Introduction to Algorithms", chapter 13: every leaf is
+//	the shared black "nil" node, which saves testing for NULL.
+//
+//     	NOTE: Mutual exclusion must be provided by the caller.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+
+//----------------------------------------------------------------------
+// RBTree<T>::RBTree
+//	Initialize a tree, empty to start with.
+//	Elements can now be added to the tree.
+//
+//	"comp" orders the items in the tree
+//----------------------------------------------------------------------
+
+template <class T>
+RBTree<T>::RBTree(int (*comp)(T x, T y))
+{
+    compare = comp;
+    nil = new RBNode<T>;
+    nil->red = FALSE;
+    nil->left = nil->right = nil->parent = nil;
+    root = leftmost = nil;
+    numInList = 0;
+    nextSeq = 0;
+}
+
+//----------------------------------------------------------------------
+// RBTree<T>::~RBTree
+//	Prepare a tree for deallocation.
+//      This does *NOT* free the items in the tree, only the nodes.
+//----------------------------------------------------------------------
+
+template <class T>
+RBTree<T>::~RBTree()
+{
+    DeleteSubtree(root);
+    delete nil;
+}
+
+template <class T>
+void
+RBTree<T>::DeleteSubtree(RBNode<T> *node)
+{
+    if (node != nil) {
+	DeleteSubtree(node->left);
+	DeleteSubtree(node->right);
+	delete node;
+    }
+}
+
+//----------------------------------------------------------------------
+// RBTree<T>::Less
+//	Return TRUE if "x" should come out of the tree before "y".
+//	Items that compare equal are ordered by insertion.
+//----------------------------------------------------------------------
+
+template <class T>
+bool
+RBTree<T>::Less(RBNode<T> *x, RBNode<T> *y) const
+{
+    int c = compare(x->item, y->item);
+
+    if (c != 0) {
+	return c < 0;
+    }
+    return x->seq < y->seq;
+}
+
+//----------------------------------------------------------------------
+// RBTree<T>::Minimum
+//	Return the leftmost node under "node", which must not be nil.
+//----------------------------------------------------------------------
+
+template <class T>
+RBNode<T> *
+RBTree<T>::Minimum(RBNode<T> *node) const
+{
+    while (node->left != nil) {
+	node = node->left;
+    }
+    return node;
+}
+
+//----------------------------------------------------------------------
+// RBTree<T>::RotateLeft, RotateRight
+//	Rotate the tree around "x": its right (left) child moves up
+//	to take x's place, and x becomes that child's left (right)
+//	child.  The in-order sequence of the tree does not change.
+//----------------------------------------------------------------------
+
+template <class T>
+void
+RBTree<T>::RotateLeft(RBNode<T> *x)
+{
+    RBNode<T> *y = x->right;
+
+    x->right = y->left;
+    if (y->left != nil) {
+	y->left->parent = x;
+    }
+    y->parent = x->parent;
+    if (x->parent == nil) {
+	root = y;
+    } else if (x == x->parent->left) {
+	x->parent->left = y;
+    } else {
+	x->parent->right = y;
+    }
+    y->left = x;
+    x->parent = y;
+}
+
+template <class T>
+void
+RBTree<T>::RotateRight(RBNode<T> *x)
+{
+    RBNode<T> *y = x->left;
+
+    x->left = y->right;
+    if (y->right != nil) {
+	y->right->parent = x;
+    }
+    y->parent = x->parent;
+    if (x->parent == nil) {
+	root = y;
+    } else if (x == x->parent->right) {
+	x->parent->right = y;
+    } else {
+	x->parent->left = y;
+    }
+    y->right = x;
+    x->parent = y;
+}
+
+//----------------------------------------------------------------------
+// RBTree<T>::Insert
+//      Insert an "item" into the tree, so that it comes out after
+//	every item that is smaller than it, or equal to it.
+//
+//	"item" is the thing to put in the tree.
+//----------------------------------------------------------------------
+
+template <class T>
+void
+RBTree<T>::Insert(T item)
+{
+    RBNode<T> *z = new RBNode<T>;
+    RBNode<T> *y = nil;
+    RBNode<T> *x = root;
+
+    z->item = item;
+    z->seq = nextSeq++;
+    while (x != nil) {			// find the leaf to hang z from
+	y = x;
+	x = Less(z, x) ? x->left : x->right;
+    }
+    z->parent = y;
+    if (y == nil) {
+	root = z;
+    } else if (Less(z, y)) {
+	y->left = z;
+    } else {
+	y->right = z;
+    }
+    z->left = z->right = nil;
+    z->red = TRUE;
+    if (leftmost == nil || Less(z, leftmost)) {
+	leftmost = z;
+    }
+    numInList++;
+    InsertFixup(z);
+}
+
+//----------------------------------------------------------------------
+// RBTree<T>::InsertFixup
+//	Restore the red-black properties after "z" was added as a red
+//	leaf: the only one that can be broken is that z's parent may
+//	be red too.
+//----------------------------------------------------------------------
+
+template <class T>
+void
+RBTree<T>::InsertFixup(RBNode<T> *z)
+{
+    while (z->parent->red) {
+	RBNode<T> *grandparent = z->parent->parent;
+
+	if (z->parent == grandparent->left) {
+	    RBNode<T> *uncle = grandparent->right;
+
+	    if (uncle->red) {		// recolour, and move up
+		z->parent->red = FALSE;
+		uncle->red = FALSE;
+		grandparent->red = TRUE;
+		z = grandparent;
+	    } else {
+		if (z == z->parent->right) {
+		    z = z->parent;
+		    RotateLeft(z);
+		}
+		z->parent->red = FALSE;
+		z->parent->parent->red = TRUE;
+		RotateRight(z->parent->parent);
+	    }
+	} else {			// same, with left and right swapped
+	    RBNode<T> *uncle = grandparent->left;
+
+	    if (uncle->red) {
+		z->parent->red = FALSE;
+		uncle->red = FALSE;
+		grandparent->red = TRUE;
+		z = grandparent;
+	    } else {
+		if (z == z->parent->left) {
+		    z = z->parent;
+		    RotateRight(z);
+		}
+		z->parent->red = FALSE;
+		z->parent->parent->red = TRUE;
+		RotateLeft(z->parent->parent);
+	    }
+	}
+    }
+    root->red = FALSE;
+}
+
+//----------------------------------------------------------------------
+// RBTree<T>::RemoveFront
+//      Remove the smallest "item" from the tree.
+//	Tree must not be empty.
+//
+// Returns:
+//	The removed item.
+//----------------------------------------------------------------------
+
+template <class T>
+T
+RBTree<T>::RemoveFront()
+{
+    T thing;
+
+    ASSERT(!IsEmpty());
+    thing = leftmost->item;
+    RemoveNode(leftmost);
+    return thing;
+}
+
+//----------------------------------------------------------------------
+// RBTree<T>::Find
+//	Return the node, under "node", that holds "item", or nil if
+//	there is none.  Only items that compare equal to "item" can
+//	be it, so for distinct keys this is one walk down the tree.
+//----------------------------------------------------------------------
+
+template <class T>
+RBNode<T> *
+RBTree<T>::Find(RBNode<T> *node, T item) const
+{
+    RBNode<T> *found;
+    int c;
+
+    if (node == nil) {
+	return nil;
+    }
+    c = compare(item, node->item);
+    if (c < 0) {
+	return Find(node->left, item);
+    } else if (c > 0) {
+	return Find(node->right, item);
+    } else if (node->item == item) {
+	return node;
+    }
+    found = Find(node->left, item);	// equal keys may be either side
+    if (found == nil) {
+	found = Find(node->right, item);
+    }
+    return found;
+}
+
+//----------------------------------------------------------------------
+// RBTree<T>::Transplant
+//	Replace the subtree rooted at "u" with the one rooted at "v".
+//----------------------------------------------------------------------
+
+template <class T>
+void
+RBTree<T>::Transplant(RBNode<T> *u, RBNode<T> *v)
+{
+    if (u->parent == nil) {
+	root = v;
+    } else if (u == u->parent->left) {
+	u->parent->left = v;
+    } else {
+	u->parent->right = v;
+    }
+    v->parent = u->parent;		// may set nil's parent; that is OK
+}
+
+//----------------------------------------------------------------------
+// RBTree<T>::Remove
+//      Remove a specific item from the tree.  Must be in the tree!
+//----------------------------------------------------------------------
+
+template <class T>
+void
+RBTree<T>::Remove(T item)
+{
+    RBNode<T> *z = Find(root, item);
+
+    ASSERT(z != nil);
+    RemoveNode(z);
+}
+
+//----------------------------------------------------------------------
+// RBTree<T>::RemoveNode
+//      Take node "z" out of the tree, and free it.
+//----------------------------------------------------------------------
+
+template <class T>
+void
+RBTree<T>::RemoveNode(RBNode<T> *z)
+{
+    RBNode<T> *y = z;
+    RBNode<T> *x;
+    bool yWasRed = y->red;
+
+    if (z == leftmost) {		// its successor is the new leftmost
+	leftmost = (z->right != nil) ? Minimum(z->right) : z->parent;
+    }
+    if (z->left == nil) {
+	x = z->right;
+	Transplant(z, z->right);
+    } else if (z->right == nil) {
+	x = z->left;
+	Transplant(z, z->left);
+    } else {				// replace z by its successor
+	y = Minimum(z->right);
+	yWasRed = y->red;
+	x = y->right;
+	if (y->parent == z) {
+	    x->parent = y;
+	} else {
+	    Transplant(y, y->right);
+	    y->right = z->right;
+	    y->right->parent = y;
+	}
+	Transplant(z, y);
+	y->left = z->left;
+	y->left->parent = y;
+	y->red = z->red;
+    }
+    if (!yWasRed) {
+	DeleteFixup(x);
+    }
+    delete z;
+    numInList--;
+    nil->parent = nil;
+}
+
+//----------------------------------------------------------------------
+// RBTree<T>::DeleteFixup
+//	Restore the red-black properties after a black node was taken
+//	out of the tree: "x" carries an "extra black" that has to be
+//	pushed up the tree until it can be dropped.
+//----------------------------------------------------------------------
+
+template <class T>
+void
+RBTree<T>::DeleteFixup(RBNode<T> *x)
+{
+    while (x != root && !x->red) {
+	if (x == x->parent->left) {
+	    RBNode<T> *w = x->parent->right;	// x's sibling
+
+	    if (w->red) {
+		w->red = FALSE;
+		x->parent->red = TRUE;
+		RotateLeft(x->parent);
+		w = x->parent->right;
+	    }
+	    if (!w->left->red && !w->right->red) {
+		w->red = TRUE;
+		x = x->parent;
+	    } else {
+		if (!w->right->red) {
+		    w->left->red = FALSE;
+		    w->red = TRUE;
+		    RotateRight(w);
+		    w = x->parent->right;
+		}
+		w->red = x->parent->red;
+		x->parent->red = FALSE;
+		w->right->red = FALSE;
+		RotateLeft(x->parent);
+		x = root;
+	    }
+	} else {			// same, with left and right swapped
+	    RBNode<T> *w = x->parent->left;
+
+	    if (w->red) {
+		w->red = FALSE;
+		x->parent->red = TRUE;
+		RotateRight(x->parent);
+		w = x->parent->left;
+	    }
+	    if (!w->right->red && !w->left->red) {
+		w->red = TRUE;
+		x = x->parent;
+	    } else {
+		if (!w->left->red) {
+		    w->right->red = FALSE;
+		    w->red = TRUE;
+		    RotateLeft(w);
+		    w = x->parent->left;
+		}
+		w->red = x->parent->red;
+		x->parent->red = FALSE;
+		w->left->red = FALSE;
+		RotateRight(x->parent);
+		x = root;
+	    }
+	}
+    }
+    x->red = FALSE;
+}
+
+//----------------------------------------------------------------------
+// RBTree<T>::IsInList
+//      Return TRUE if the item is in the tree.
+//----------------------------------------------------------------------
+
+template <class T>
+bool
+RBTree<T>::IsInList(T item) const
+{
+    return Find(root, item) != nil;
+}
+
+//----------------------------------------------------------------------
+// RBTree<T>::Apply
+//      Apply function to every item in the tree, smallest first.
+//
+//	"func" -- the function to apply
+//----------------------------------------------------------------------
+
+template <class T>
+void
+RBTree<T>::Apply(void (*func)(T)) const
+{
+    ApplyTo(root, func);
+}
+
+template <class T>
+void
+RBTree<T>::ApplyTo(RBNode<T> *node, void (*func)(T)) const
+{
+    if (node != nil) {
+	ApplyTo(node->left, func);
+	(*func)(node->item);
+	ApplyTo(node->right, func);
+    }
+}
+
+//----------------------------------------------------------------------
+// RBTree<T>::SanityCheck
+//      Test whether this is still a legal red-black tree.
+//
+//	Tests: is the root black?
+//	       is every node in order with its children?
+//	       does no red node have a red child?
+//	       does every path have the same number of black nodes?
+//	       is the cached leftmost node really the smallest?
+//----------------------------------------------------------------------
+
+template <class T>
+void
+RBTree<T>::SanityCheck() const
+{
+    ASSERT(!root->red && !nil->red);
+    ASSERT(root->parent == nil);
+    CheckSubtree(root);
+    if (numInList == 0) {
+	ASSERT(root == nil && leftmost == nil);
+    } else {
+	ASSERT(leftmost == Minimum(root));
+    }
+}
+
+template <class T>
+int
+RBTree<T>::CheckSubtree(RBNode<T> *node) const
+{
+    int leftHeight, rightHeight;
+
+    if (node == nil) {
+	return 1;
+    }
+    if (node->left != nil) {
+	ASSERT(node->left->parent == node && Less(node->left, node));
+    }
+    if (node->right != nil) {
+	ASSERT(node->right->parent == node && Less(node, node->right));
+    }
+    if (node->red) {
+	ASSERT(!node->left->red && !node->right->red);
+    }
+    leftHeight = CheckSubtree(node->left);
+    rightHeight = CheckSubtree(node->right);
+    ASSERT(leftHeight == rightHeight);
+    return leftHeight + (node->red ? 0 : 1);
+}
+
+//----------------------------------------------------------------------
+// RBTree<T>::SelfTest
+//      Test whether this module is working.
+//----------------------------------------------------------------------
+
+template <class T>
+void
+RBTree<T>::SelfTest(T *p, int numEntries)
+{
+    int i;
+    T *q = new T[numEntries];
+
+    SanityCheck();
+    ASSERT(IsEmpty());
+
+    for (i = 0; i < numEntries; i++) {
+	Insert(p[i]);
+	ASSERT(IsInList(p[i]));
+	ASSERT(!IsEmpty());
+	SanityCheck();
+    }
+
+    // should be able to take out anything we put in
+    Remove(p[0]);
+    ASSERT(!IsInList(p[0]));
+    SanityCheck();
+    Insert(p[0]);
+    SanityCheck();
+
+    // should be able to get out everything we put in, in order
+    for (i = 0; i < numEntries; i++) {
+	q[i] = RemoveFront();
+	ASSERT(!IsInList(q[i]));
+	SanityCheck();
+    }
+    ASSERT(IsEmpty());
+
+    // make sure everything came out in the right order
+    for (i = 0; i < (numEntries - 1); i++) {
+	ASSERT(compare(q[i], q[i + 1]) <= 0);
+    }
+
+    delete [] q;
+}
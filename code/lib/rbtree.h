@@ -0,0 +1,114 @@
+// rbtree.h
+//	Data structures to manage a red-black tree -- a balanced binary
+//	search tree.
+//
+//	Like a SortedList, an RBTree keeps its items ordered by a
+//	"Compare" function, and RemoveFront always returns the smallest
+//	item.  Unlike a SortedList, Insert and Remove take O(log n)
+//	time, because the tree is kept balanced: every path from the
+//	root to a leaf has the same number of black nodes, and a red
+//	node never has a red child, so no path is more than twice as
+//	long as any other.  The leftmost (smallest) node is cached, so
+//	Front is O(1).
+//
+//	Items that compare equal come out in the order they were put
+//	in, as with SortedList::Insert.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef RBTREE_H
+#define RBTREE_H
+
+#include "copyright.h"
+#include "debug.h"
+
+// The following class defines a "tree node" -- one item, plus the
+// links and colour that keep it in the tree.
+//
+// This class is private to this module.  Made public for notational
+// convenience.
+
+template <class T>
+class RBNode {
+  public:
+    T item;			// item in the tree
+    unsigned int seq;		// insertion order, for ties
+    bool red;			// colour of the node
+    RBNode<T> *left;		// smaller items
+    RBNode<T> *right;		// larger items
+    RBNode<T> *parent;		// the node we hang from
+};
+
+// The following class defines a red-black tree.  All types to be put
+// in a tree must have a "Compare" function defined, with the same
+// meaning as for SortedList:
+//	   int Compare(T x, T y)
+//		returns -1 if x < y
+//		returns 0 if x == y
+//		returns 1 if x > y
+
+template <class T>
+class RBTree {
+  public:
+    RBTree(int (*comp)(T x, T y));	// initialize the tree
+    ~RBTree();			// de-allocate the tree
+
+    void Insert(T item);	// put an item in the tree in sorted order
+
+    T Front() { ASSERT(!IsEmpty()); return leftmost->item; }
+    				// Return smallest item in the tree
+				// without removing it
+    T RemoveFront(); 		// Take smallest item out of the tree
+    void Remove(T item); 	// Remove specific item from the tree
+
+    bool IsInList(T item) const;// is the item in the tree?
+
+    unsigned int NumInList() { return numInList; }
+    				// how many items in the tree?
+    bool IsEmpty() { return (numInList == 0); }
+    				// is the tree empty?
+
+    void Apply(void (*f)(T)) const;
+    				// apply function to all items in the
+				// tree, smallest first
+
+    void SanityCheck() const;	// has this tree been corrupted?
+    void SelfTest(T *p, int numEntries);
+				// verify module is working
+
+  private:
+    int (*compare)(T x, T y);	// function for ordering items
+    RBNode<T> *root;		// top of the tree
+    RBNode<T> *nil;		// the (black) leaf every path ends at
+    RBNode<T> *leftmost;	// the smallest node, nil if empty
+    int numInList;		// number of items in the tree
+    unsigned int nextSeq;	// sequence number for the next Insert
+
+    bool Less(RBNode<T> *x, RBNode<T> *y) const;
+				// does x come out before y?
+    RBNode<T> *Find(RBNode<T> *node, T item) const;
+				// the node holding item, under "node"
+    RBNode<T> *Minimum(RBNode<T> *node) const;
+				// smallest node under "node"
+    void RotateLeft(RBNode<T> *x);	// x's right child takes its place
+    void RotateRight(RBNode<T> *x);	// x's left child takes its place
+    void Transplant(RBNode<T> *u, RBNode<T> *v);
+				// put v where u was
+    void InsertFixup(RBNode<T> *z);	// rebalance after an insert
+    void RemoveNode(RBNode<T> *z);	// take a node out of the tree
+    void DeleteFixup(RBNode<T> *x);	// rebalance after a delete
+    void ApplyTo(RBNode<T> *node, void (*f)(T)) const;
+				// Apply, for the subtree under "node"
+    int CheckSubtree(RBNode<T> *node) const;
+				// SanityCheck the subtree under "node",
+				// return its black height
+    void DeleteSubtree(RBNode<T> *node);
+				// free the nodes under "node"
+};
+
+#include "rbtree.cc"		// templates are really like macros
+				// so needs to be included in every
+				// file that uses the template
+#endif // RBTREE_H
@@ -0,0 +1,85 @@
+// spec.cc
+//	Routines to pick apart "name[:param]" specifications.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "spec.h"
+#include "sysdep.h"
+
+//----------------------------------------------------------------------
+// Spec::Spec
+//	Find the name and the parameter in "spec".  Nothing is copied,
+//	so "spec" must outlive us.
+//----------------------------------------------------------------------
+
+Spec::Spec(char *spec)
+{
+    char *colon = strchr(spec, ':');
+
+    name = spec;
+    nameLength = colon == NULL ? strlen(spec) : colon - spec;
+    param = colon == NULL ? NULL : colon + 1;
+}
+
+//----------------------------------------------------------------------
+// Spec::Is
+//	Return TRUE if the specification names "wanted".
+//----------------------------------------------------------------------
+
+bool
+Spec::Is(char *wanted)
+{
+    return strncmp(name, wanted, nameLength) == 0
+				&& wanted[nameLength] == '\0';
+}
+
+//----------------------------------------------------------------------
+// Spec::IntParam
+//	Set "value" to the parameter, a whole number, or to "byDefault"
+//	if there is no parameter.  Return FALSE, leaving "value" alone,
+//	if the parameter is not a number from "low" to "high".
+//----------------------------------------------------------------------
+
+bool
+Spec::IntParam(int *value, int byDefault, int low, int high)
+{
+    char *end;
+    long n;
+
+    if (param == NULL) {
+	*value = byDefault;
+	return TRUE;
+    }
+    n = strtol(param, &end, 10);
+    if (end == param || *end != '\0' || n < low || n > high) {
+	return FALSE;
+    }
+    *value = n;
+    return TRUE;
+}
+
+//----------------------------------------------------------------------
+// Spec::DoubleParam
+//	As IntParam, for a parameter that may have a fraction.
+//----------------------------------------------------------------------
+
+bool
+Spec::DoubleParam(double *value, double byDefault, double low, double high)
+{
+    char *end;
+    double x;
+
+    if (param == NULL) {
+	*value = byDefault;
+	return TRUE;
+    }
+    x = strtod(param, &end);
+    if (end == param || *end != '\0' || !(x >= low && x <= high)) {
+	return FALSE;
+    }
+    *value = x;
+    return TRUE;
+}
@@ -0,0 +1,43 @@
+// spec.h
+//	Data structures for the "name[:param]" specifications used on
+//	the command line to pick a policy and, optionally, its one
+//	parameter -- for instance "-burst exp:0.25" or "-replace lru:16"
+//	(see NewBurstEstimator and NewReplacementPolicy).
+//
+//	A parameter that is not a number, or is out of range, makes the
+//	whole specification bad, so the caller can report it rather than
+//	run with a made-up value.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef SPEC_H
+#define SPEC_H
+
+#include "copyright.h"
+#include "utility.h"
+
+class Spec {
+  public:
+    Spec(char *spec);		// split "spec" at the ':', if any
+
+    bool Is(char *wanted);	// is "wanted" the name asked for?
+
+    char *Param() { return param; }
+				// the parameter; NULL if there is none
+    bool IntParam(int *value, int byDefault, int low, int high);
+    bool DoubleParam(double *value, double byDefault,
+					double low, double high);
+				// set "value" to the parameter, or to
+				// "byDefault" if there is none; FALSE if
+				// the parameter is not a number from
+				// "low" to "high"
+
+  private:
+    char *name;			// the specification, up to the ':'
+    int nameLength;
+    char *param;		// what follows the ':', or NULL
+};
+
+#endif // SPEC_H
@@ -50,6 +50,7 @@
 extern "C" {
 #include <signal.h>
 #include <sys/types.h>
+#include <sys/stat.h>
 
 #ifndef NO_MPROT 
 #include <sys/mman.h>
@@ -421,6 +422,27 @@ Unlink(char *name)
     return unlink(name);
 }
 
+//----------------------------------------------------------------------
+// FileIdentity
+// 	Find which file "name" is, and when it last changed: its inode
+//	number, and modification time.  Two opens of the same name with
+//	the same identity read the same bytes.  Return FALSE if there is
+//	no such file.
+//----------------------------------------------------------------------
+
+bool
+FileIdentity(char *name, long *inode, long *mtime)
+{
+    struct stat info;
+
+    if (stat(name, &info) != 0) {
+	return FALSE;
+    }
+    *inode = (long) info.st_ino;
+    *mtime = (long) info.st_mtime;
+    return TRUE;
+}
+
 //----------------------------------------------------------------------
 // OpenSocket
 // 	Open an interprocess communication (IPC) connection.  For now, 
@@ -13,6 +13,7 @@
 
 #include "copyright.h"
 #include <iostream>
+#include <fstream>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -52,6 +53,7 @@ extern void Lseek(int fd, int offset, int whence);
 extern int Tell(int fd);
 extern int Close(int fd);
 extern bool Unlink(char *name);
+extern bool FileIdentity(char *name, long *inode, long *mtime);
 
 // Other C library routines that are used by Nachos.
 // These are assumed to be portable, so we don't include a wrapper.
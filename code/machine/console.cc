@@ -59,22 +59,40 @@ ConsoleInput::~ConsoleInput()
 //
 //	First check to make sure character is available.
 //	Then invoke the "callBack" registered by whoever wants the character.
+//
+//	What we found -- nothing, end of file, or a character -- is
+//	a nondeterministic input, so it goes through the replay log;
+//	when replaying, we don't look at the file at all.
 //----------------------------------------------------------------------
 
+static const int NothingToRead = -2;	// what we found, besides a
+static const int EndOfInput = -3;	// character
+
 void
 ConsoleInput::CallBack()
 {
   char c;
   int readCount;
+  int found = NothingToRead;
 
     ASSERT(incoming == EOF);
-    if (!PollFile(readFileNo)) { // nothing to be read
+    if (!kernel->replay->Replaying() && PollFile(readFileNo)) {
+    	// try to read a character
+    	readCount = ReadPartial(readFileNo, &c, sizeof(char));
+	if (readCount == 0) {
+	   found = EndOfInput;
+	} else {
+	   ASSERT(readCount == sizeof(char));
+	   found = (unsigned char) c;
+	}
+    }
+    found = kernel->replay->Input(ReplayConsole, found);
+
+    if (found == NothingToRead) { // nothing to be read
         // schedule the next time to poll for a packet
         kernel->interrupt->Schedule(this, ConsoleTime, ConsoleReadInt);
     } else { 
-    	// otherwise, try to read a character
-    	readCount = ReadPartial(readFileNo, &c, sizeof(char));
-	if (readCount == 0) {
+	if (found == EndOfInput) {
 	   // this seems to happen at end of file, when the
 	   // console input is a regular file
 	   // don't schedule an interrupt, since there will never
@@ -84,8 +102,7 @@ ConsoleInput::CallBack()
 	else {
 	  // save the character and notify the OS that
 	  // it is available
-	  ASSERT(readCount == sizeof(char));
-	  incoming = c;
+	  incoming = found;
 	  kernel->stats->numConsoleCharsRead++;
 	}
 	callWhenAvail->CallBack();
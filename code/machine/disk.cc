@@ -113,7 +113,8 @@ PrintSector (bool writing, int sector, char *data)
 void
 Disk::ReadRequest(int sectorNumber, char* data)
 {
-    int ticks = ComputeLatency(sectorNumber, FALSE);
+    int ticks = kernel->replay->Input(ReplayDisk,
+				ComputeLatency(sectorNumber, FALSE));
 
     ASSERT(!active);				// only one request at a time
     ASSERT((sectorNumber >= 0) && (sectorNumber < NumSectors));
@@ -133,7 +134,8 @@ Disk::ReadRequest(int sectorNumber, char* data)
 void
 Disk::WriteRequest(int sectorNumber, char* data)
 {
-    int ticks = ComputeLatency(sectorNumber, TRUE);
+    int ticks = kernel->replay->Input(ReplayDisk,
+				ComputeLatency(sectorNumber, TRUE));
 
     ASSERT(!active);
     ASSERT((sectorNumber >= 0) && (sectorNumber < NumSectors));
@@ -29,7 +29,7 @@
 static char *intLevelNames[] = { "off", "on"};
 static char *intTypeNames[] = { "timer", "disk", "console write", 
 			"console read", "network send", 
-			"network recv"};
+			"network recv", "arrival"};
 
 //----------------------------------------------------------------------
 // PendingInterrupt::PendingInterrupt
@@ -47,6 +47,7 @@ PendingInterrupt::PendingInterrupt(CallBackObj *callOnInt,
     callOnInterrupt = callOnInt;
     when = time;
     type = kind;
+    heapIndex = -1;
 }
 
 //----------------------------------------------------------------------
@@ -62,6 +63,17 @@ PendingCompare (PendingInterrupt *x, PendingInterrupt *y)
     else { return 0; }
 }
 
+//----------------------------------------------------------------------
+// PendingHandle
+//	Tell the pending heap where an interrupt keeps its heap index.
+//----------------------------------------------------------------------
+
+static int *
+PendingHandle (PendingInterrupt *x)
+{
+    return &x->heapIndex;
+}
+
 //----------------------------------------------------------------------
 // Interrupt::Interrupt
 // 	Initialize the simulation of hardware device interrupts.
@@ -72,7 +84,10 @@ PendingCompare (PendingInterrupt *x, PendingInterrupt *y)
 Interrupt::Interrupt()
 {
     level = IntOff;
-    pending = new SortedList<PendingInterrupt *>(PendingCompare);
+    pending = new Heap<PendingInterrupt *>(PendingCompare, PendingHandle);
+    freePending = new IntrusiveList<PendingInterrupt,
+				&PendingInterrupt::hook>;
+    nextDue = NeverDue;
     inHandler = FALSE;
     yieldOnReturn = FALSE;
     status = SystemMode;
@@ -89,6 +104,10 @@ Interrupt::~Interrupt()
 	delete pending->RemoveFront();
     }
     delete pending;
+    while (!freePending->IsEmpty()) {
+	delete freePending->RemoveFront();
+    }
+    delete freePending;
 }
 
 //----------------------------------------------------------------------
@@ -143,6 +162,10 @@ Interrupt::SetLevel(IntStatus now)
 //	Two things can cause OneTick to be called:
 //		interrupts are re-enabled
 //		a user instruction is executed
+//
+//	Nearly always, no interrupt is due yet, and there is no context
+//	switch to do: we need only advance the clock.  When we are not
+//	printing the interrupt state on each tick, we stop there.
 //----------------------------------------------------------------------
 void
 Interrupt::OneTick()
@@ -159,6 +182,10 @@ Interrupt::OneTick()
 	stats->userTicks += UserTick;
     }
     DEBUG(dbgInt, "== Tick " << stats->totalTicks << " ==");
+    if (stats->totalTicks < nextDue && !yieldOnReturn
+				&& !debug->IsEnabled(dbgInt)) {
+	return;			// nothing to fire
+    }
 
 // check any pending interrupts are now ready to fire
     ChangeLevel(IntOn, IntOff);	// first, turn off interrupts
@@ -239,6 +266,11 @@ Interrupt::Halt()
     cout << "Machine halting!\n\n";
     cout << "This is halt\n";
     kernel->stats->Print();
+    kernel->threadStats->Print();
+    kernel->scheduler->Report();
+    kernel->burstEstimator->Report();
+    kernel->burstProfile->Save();
+    kernel->replay->Print();
     delete kernel;	// Never returns.
 }
 /*
@@ -284,7 +316,10 @@ Interrupt::CloseFile(OpenFileId id)
 // 	Arrange for the CPU to be interrupted when simulated time
 //	reaches "now + when".
 //
-//	Implementation: just put it on a sorted list.
+//	Implementation: put it on a heap, soonest first; interrupts
+//	due at the same tick fire in the order they were scheduled.
+//	The PendingInterrupt is reused from one that has fired, if
+//	there is one, so in the steady state nothing is allocated.
 //
 //	NOTE: the Nachos kernel should not call this routine directly.
 //	Instead, it is only called by the hardware device simulators.
@@ -298,12 +333,22 @@ void
 Interrupt::Schedule(CallBackObj *toCall, int fromNow, IntType type)
 {
     int when = kernel->stats->totalTicks + fromNow;
-    PendingInterrupt *toOccur = new PendingInterrupt(toCall, when, type);
+    PendingInterrupt *toOccur;
+
+    if (freePending->IsEmpty()) {
+	toOccur = new PendingInterrupt(toCall, when, type);
+    } else {				// reuse one that has fired
+	toOccur = freePending->RemoveFront();
+	toOccur->callOnInterrupt = toCall;
+	toOccur->when = when;
+	toOccur->type = type;
+    }
 
     DEBUG(dbgInt, "Scheduling interrupt handler the " << intTypeNames[type] << " at time = " << when);
     ASSERT(fromNow > 0);
 
     pending->Insert(toOccur);
+    nextDue = pending->Front()->when;
 }
 
 //----------------------------------------------------------------------
@@ -358,9 +403,10 @@ Interrupt::CheckIfDue(bool advanceClock)
 		DEBUG(dbgTraCode, "In Interrupt::CheckIfDue, into callOnInterrupt->CallBack, " << stats->totalTicks);
         next->callOnInterrupt->CallBack();// call the interrupt handler
 		DEBUG(dbgTraCode, "In Interrupt::CheckIfDue, return from callOnInterrupt->CallBack, " << stats->totalTicks);
-	delete next;
+	freePending->Prepend(next);	// to be reused
     } while (!pending->IsEmpty() 
     		&& (pending->Front()->when <= stats->totalTicks));
+    nextDue = pending->IsEmpty() ? NeverDue : pending->Front()->when;
     inHandler = FALSE;
     return TRUE;
 }
@@ -390,7 +436,7 @@ Interrupt::DumpState()
     cout << "Time: " << kernel->stats->totalTicks;
     cout << ", interrupts " << intLevelNames[level] << "\n";
     cout << "Pending interrupts:\n";
-    pending->Apply(PrintPending);
+    pending->ApplySorted(PrintPending);
     cout << "\nEnd of pending interrupts\n";
 }
 
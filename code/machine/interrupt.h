@@ -35,6 +35,8 @@
 
 #include "copyright.h"
 #include "list.h"
+#include "intrusivelist.h"
+#include "heap.h"
 #include "callback.h"
 
 // Interrupts can be disabled (IntOff) or enabled (IntOn)
@@ -47,9 +49,13 @@ enum MachineStatus {IdleMode, SystemMode, UserMode};
 
 // IntType records which hardware device generated an interrupt.
 // In Nachos, we support a hardware timer device, a disk, a console
-// display and keyboard, and a network.
+// display and keyboard, and a network.  ArrivalInt is not a device:
+// it starts user programs at the ticks a workload asks for.
 enum IntType { TimerInt, DiskInt, ConsoleWriteInt, ConsoleReadInt, 
-			NetworkSendInt, NetworkRecvInt};
+			NetworkSendInt, NetworkRecvInt, ArrivalInt};
+
+// NextDue when no interrupt is pending
+const int NeverDue = 0x7fffffff;
 
 // The following class defines an interrupt that is scheduled
 // to occur in the future.  The internal data structures are
@@ -68,6 +74,10 @@ class PendingInterrupt {
     
     int when;			// When the interrupt is supposed to fire
     IntType type;		// for debugging
+    int heapIndex;		// where we are on the pending heap,
+				// -1 if we are not on it
+    ListHook<PendingInterrupt> hook;	// our links on the free list,
+				// once we have fired
 };
 
 // The following class defines the data structures for the simulation
@@ -126,11 +136,25 @@ class Interrupt {
     
     void OneTick();       	// Advance simulated time
 
+    int NextDue() { return nextDue; }
+				// when the soonest pending interrupt is
+				// due; NeverDue if none is pending
+    bool QuietUntil(int when)
+	{ return status == UserMode && when < nextDue && !yieldOnReturn; }
+				// would ticking user instructions up to
+				// "when" do nothing but advance the clock?
+
   private:
     IntStatus level;		// are interrupts enabled or disabled?
-    SortedList<PendingInterrupt *> *pending;		
-    				// the list of interrupts scheduled
-				// to occur in the future
+    Heap<PendingInterrupt *> *pending;
+    				// the interrupts scheduled to occur
+				// in the future, soonest first
+    IntrusiveList<PendingInterrupt, &PendingInterrupt::hook> *freePending;
+				// PendingInterrupts that have fired,
+				// to be reused by Schedule
+    int nextDue;		// when pending->Front() is due, NeverDue
+				// if nothing is pending; saves OneTick
+				// looking at the heap on every tick
     //int writeFileNo;            //UNIX file emulating the display
     bool inHandler;		// TRUE if we are running an interrupt handler
     //bool putBusy;               // Is a PrintInt operation in progress
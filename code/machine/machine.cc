@@ -11,6 +11,15 @@
 #include "machine.h"
 #include "main.h"
 
+// The size of memory; see machine.h.  Set by Machine::Machine.
+int PageSize = DefaultPageSize;
+int PageShift = 7;
+unsigned int PageMask = DefaultPageSize - 1;
+int NumPhysPages = DefaultNumPhysPages;
+int MemorySize = DefaultNumPhysPages * DefaultPageSize;
+int TLBSize = DefaultTLBSize;
+int InstrsPerPage = DefaultPageSize / 4;
+
 // Textual names of the exceptions that can be generated by user program
 // execution, for debugging.
 static char* exceptionNames[] = { "no exception", "syscall", 
@@ -50,12 +59,35 @@ void CheckEndian()
 //
 //	"debug" -- if TRUE, drop into the debugger after each user instruction
 //		is executed.
+//	"pageSize" -- bytes in a page; a power of 2, at least 16
+//	"numPhysPages" -- pages of physical memory
+//	"tlbSize" -- entries in the TLB, if there is one
 //----------------------------------------------------------------------
 
-Machine::Machine(bool debug)
+Machine::Machine(bool debug, int pageSize, int numPhysPages, int tlbSize)
 {
     int i;
 
+    if (pageSize < 16 || (pageSize & (pageSize - 1)) != 0) {
+	cout << "Page size must be a power of 2, at least 16\n";
+	ASSERT(FALSE);
+    }
+    if (numPhysPages <= 0 || numPhysPages > 0x7fffffff / pageSize
+						|| tlbSize <= 0) {
+	cout << "Bad memory size: " << numPhysPages << " pages, TLB "
+		<< tlbSize << "\n";
+	ASSERT(FALSE);
+    }
+    PageSize = pageSize;
+    for (PageShift = 0; (1 << PageShift) < pageSize; PageShift++) {
+	;
+    }
+    PageMask = pageSize - 1;
+    NumPhysPages = numPhysPages;
+    MemorySize = numPhysPages * pageSize;
+    TLBSize = tlbSize;
+    InstrsPerPage = pageSize / 4;
+
     for (i = 0; i < NumTotalRegs; i++)
         registers[i] = 0;
     mainMemory = new char[MemorySize];
@@ -71,6 +103,13 @@ Machine::Machine(bool debug)
     pageTable = NULL;
 #endif
 
+    decoded = new Instruction[NumPhysPages * InstrsPerPage];
+    pageDecoded = new bool[NumPhysPages];
+    for (i = 0; i < NumPhysPages; i++)
+	pageDecoded[i] = FALSE;
+    blockTicks = 0;
+    trapped = FALSE;
+
     singleStep = debug;
     CheckEndian();
 }
@@ -83,6 +122,8 @@ Machine::Machine(bool debug)
 Machine::~Machine()
 {
     delete [] mainMemory;
+    delete [] decoded;
+    delete [] pageDecoded;
     if (tlb != NULL)
         delete [] tlb;
 }
@@ -93,6 +134,10 @@ Machine::~Machine()
 //	the user program either invoked a system call, or some exception
 //	occured (such as the address translation failed).
 //
+//	If we are in the middle of a basic block (see RunBlock), first
+//	charge the ticks of the instructions run so far, so the kernel
+//	sees the time it would have if we ran them one by one.
+//
 //	"which" -- the cause of the kernel trap
 //	"badVaddr" -- the virtual address causing the trap, if appropriate
 //----------------------------------------------------------------------
@@ -100,12 +145,18 @@ Machine::~Machine()
 void
 Machine::RaiseException(ExceptionType which, int badVAddr)
 {
+    kernel->stats->totalTicks += blockTicks;
+    kernel->stats->userTicks += blockTicks;
+    blockTicks = 0;
+    trapped = TRUE;
+
     DEBUG(dbgMach, "Exception: " << exceptionNames[which]);
     registers[BadVAddrReg] = badVAddr;
     DelayedLoad(0, 0);			// finish anything in progress
     kernel->interrupt->setStatus(SystemMode);
     ExceptionHandler(which);		// interrupts are enabled at this point
     kernel->interrupt->setStatus(UserMode);
+    trapped = TRUE;			// other threads' blocks may have run
 }
 
 //----------------------------------------------------------------------
@@ -203,6 +254,35 @@ Machine::DumpState()
     cout << "\tLoadV:\t" << registers[LoadValueReg] << "\n";
 }
 
+//----------------------------------------------------------------------
+// Machine::InvalidateDecoded
+//	The kernel has written "size" bytes of main memory at "physAddr"
+//	without going through WriteMem -- for instance, loading a
+//	program, or reading from a file into a user buffer.  Forget the
+//	decoded instructions of the pages written to, so they are
+//	decoded again from what is there now.
+//----------------------------------------------------------------------
+
+void
+Machine::InvalidateDecoded(int physAddr, int size)
+{
+    int first = physAddr >> PageShift;
+    int last = (physAddr + size - 1) >> PageShift;
+
+    if (size <= 0) {
+	return;
+    }
+    if (first < 0) {
+	first = 0;
+    }
+    if (last >= NumPhysPages) {
+	last = NumPhysPages - 1;
+    }
+    for (int frame = first; frame <= last; frame++) {
+	pageDecoded[frame] = FALSE;
+    }
+}
+
 //----------------------------------------------------------------------
 // Machine::ReadRegister/WriteRegister
 //   	Fetch or write the contents of a user program register.
@@ -25,20 +25,63 @@
 #include "utility.h"
 #include "translate.h"
 
-// Definitions related to the size, and format of user memory
+// Definitions related to the size, and format of user memory.
+//
+// These are set when the Machine is made, from the command line
+// (see Machine::Machine), so that memory can be sized without
+// rebuilding; the defaults are below.  The page size must be a
+// power of 2, so that a virtual address splits into page and offset
+// with a shift and a mask.  It need not equal the disk sector size:
+// a page is paged out to as many sectors as it takes.
+
+const int DefaultPageSize = 128;
+const int DefaultNumPhysPages = 128;
+const int DefaultTLBSize = 4;		// if there is a TLB, make it small
+
+extern int PageSize;			// bytes in a page
+extern int PageShift;			// log2(PageSize): the page of
+extern unsigned int PageMask;		// "addr" is addr >> PageShift, and
+					// the offset in it addr & PageMask
+extern int NumPhysPages;		// pages of physical memory
+extern int MemorySize;			// NumPhysPages * PageSize
+extern int TLBSize;			// entries in the TLB, if there is one
+extern int InstrsPerPage;		// instructions in a page
+
+// The following class defines a small direct-mapped cache of address
+// translations, from a virtual page to where the page is in
+// mainMemory.  The machine keeps one for reads and one for writes, so
+// that most memory references need not go through Machine::Translate
+// (see ReadMem).  It is not part of the simulated hardware: the
+// Nachos kernel never sees it, but must tell the machine when the
+// translations may have changed (see FlushTranslations).
+
+const int TranslationCacheSize = 64;	// a power of 2
+
+class TranslationCache {
+  public:
+    TranslationCache() { Flush(); }
 
-const int PageSize = 128; 		// set the page size equal to
-					// the disk sector size, for simplicity
+    void Flush()		// forget all the translations
+	{ for (int i = 0; i < TranslationCacheSize; i++) vpn[i] = -1; }
 
-//
-// You are allowed to change this value.
-// Doing so will change the number of pages of physical memory
-// available on the simulated machine.
-//
-const int NumPhysPages = 128;
+    char *Lookup(int virtAddr)	// where virtAddr is, or NULL if we
+				// don't know
+	{ unsigned int page = (unsigned) virtAddr >> PageShift;
+	  int slot = page & (TranslationCacheSize - 1);
+	  return (vpn[slot] == (int) page) ?
+	  	frame[slot] + ((unsigned) virtAddr & PageMask) : NULL; }
 
-const int MemorySize = (NumPhysPages * PageSize);
-const int TLBSize = 4;			// if there is a TLB, make it small
+    void Enter(int virtAddr, char *hostAddr)
+				// virtAddr is at hostAddr in mainMemory
+	{ unsigned int page = (unsigned) virtAddr >> PageShift;
+	  int slot = page & (TranslationCacheSize - 1);
+	  vpn[slot] = page;
+	  frame[slot] = hostAddr - ((unsigned) virtAddr & PageMask); }
+
+  private:
+    int vpn[TranslationCacheSize];	// virtual page in each slot, or -1
+    char *frame[TranslationCacheSize];	// where the page is in mainMemory
+};
 
 enum ExceptionType { NoException,           // Everything ok!
 		     SyscallException,      // A program executed a system call.
@@ -88,13 +131,41 @@ enum ExceptionType { NoException,           // Everything ok!
 // The procedures in this class are defined in machine.cc, mipssim.cc, and
 // translate.cc.
 
-class Instruction;
+// The following class defines an instruction, represented in both
+// 	undecoded binary form
+//      decoded to identify
+//	    operation to do
+//	    registers to act on
+//	    any immediate operand value
+
+class Instruction {
+  public:
+    void Decode();	// decode the binary representation of the instruction
+
+    unsigned int value; // binary representation of the instruction
+
+    char opCode;     // Type of instruction.  This is NOT the same as the
+    		     // opcode field from the instruction: see defs in mips.h
+    char rs, rt, rd; // Three registers from instruction.
+    int extra;       // Immediate or target or shamt field or offset.
+                     // Immediates are sign-extended.
+    int blockLength; // Instructions from this one to the end of its
+		     // basic block, within its page (see FetchInstruction)
+#ifdef DIRECT_DISPATCH
+    void *handler;   // Where Execute runs this opCode
+#endif
+};
+
 class Interrupt;
 
 class Machine {
   public:
-    Machine(bool debug);	// Initialize the simulation of the hardware
-				// for running user programs
+    Machine(bool debug, int pageSize = DefaultPageSize,
+		int numPhysPages = DefaultNumPhysPages,
+		int tlbSize = DefaultTLBSize);
+				// Initialize the simulation of the hardware
+				// for running user programs, with memory
+				// of the given size
     ~Machine();			// De-allocate the data structures
 
 // Routines callable by the Nachos kernel
@@ -143,14 +214,33 @@ class Machine {
     				// Read or write 1, 2, or 4 bytes of virtual 
 				// memory (at addr).  Return FALSE if a 
 				// correct translation couldn't be found.
+
+    void InvalidateDecoded(int physAddr, int size);
+				// The kernel has changed "size" bytes of
+				// mainMemory at "physAddr" itself; any
+				// instructions decoded from them are stale
+
+    void FlushTranslations()	// The kernel has switched page tables,
+				// or changed an entry in one (including
+				// clearing a use or dirty bit)
+	{ readCache.Flush(); writeCache.Flush(); }
   private:
 
 // Routines internal to the machine simulation -- DO NOT call these directly
     void DelayedLoad(int nextReg, int nextVal);  	
 				// Do a pending delayed load (modifying a reg)
 
-    void OneInstruction(Instruction *instr); 	
-    				// Run one instruction of a user program.
+    void OneInstruction(); 	// Run one instruction of a user program.
+    void RunBlock(int maxSteps);
+				// Run the rest of a basic block, up to
+				// maxSteps instructions, and charge
+				// their ticks
+    void Execute(Instruction *instr, int maxSteps);
+				// Run a fetched instruction, and up to
+				// maxSteps - 1 after it in its block
+    Instruction *FetchInstruction(int addr);
+				// Read and decode the instruction at addr,
+				// or raise an exception and return NULL
     
 
 
@@ -178,6 +268,21 @@ class Machine {
     int runUntilTime;		// drop back into the debugger when simulated
 				// time reaches this value
 
+    Instruction *decoded;	// decoded[physAddr / 4] is the instruction
+				// at physAddr, if its page is decoded
+    bool *pageDecoded;		// pageDecoded[frame] is TRUE if decoded
+				// holds the frame's instructions
+    int blockTicks;		// ticks RunBlock has yet to charge
+
+    TranslationCache readCache;	// pages we have read (or written) since
+				// the last flush, so their use bits are
+				// set, and they can be read
+    TranslationCache writeCache; // pages we have written since the last
+				// flush, so their dirty bits are set too
+    void CacheTranslation(int virtAddr, int physAddr, bool writing);
+				// remember a translation Translate made
+    bool trapped;		// has RunBlock's block trapped?
+
     friend class Interrupt;		// calls DelayedLoad()    
 };
 
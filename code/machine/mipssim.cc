@@ -24,25 +24,22 @@
 
 static void Mult(int a, int b, bool signedArith, int* hiPtr, int* loPtr);
 
-// The following class defines an instruction, represented in both
-// 	undecoded binary form
-//      decoded to identify
-//	    operation to do
-//	    registers to act on
-//	    any immediate operand value
-
-class Instruction {
-  public:
-    void Decode();	// decode the binary representation of the instruction
-
-    unsigned int value; // binary representation of the instruction
-
-    char opCode;     // Type of instruction.  This is NOT the same as the
-    		     // opcode field from the instruction: see defs in mips.h
-    char rs, rt, rd; // Three registers from instruction.
-    int extra;       // Immediate or target or shamt field or offset.
-                     // Immediates are sign-extended.
-};
+// Normally Execute switches on the opcode of each instruction it runs.
+// Built with -DDIRECT_DISPATCH, each decoded instruction instead holds
+// the address of the code for its opcode (a GNU C++ extension), and
+// Execute jumps from the end of one instruction straight to the code
+// for the next, without going back through the switch.  The code run
+// for each opcode is the same either way.
+
+#ifdef DIRECT_DISPATCH
+#define OPCASE(op)	case op: L_##op:
+#define OPDEFAULT	default: L_default:
+
+static void **opHandlers = NULL;	// code for each opCode, in Execute
+#else
+#define OPCASE(op)	case op:
+#define OPDEFAULT	default:
+#endif
 
 //----------------------------------------------------------------------
 // Machine::Run
@@ -51,12 +48,20 @@ class Instruction {
 //
 //	This routine is re-entrant, in that it can be called multiple
 //	times concurrently -- one for each thread executing user code.
+//
+//	Most instructions end with nothing for OneTick to do but advance
+//	the clock, so while the next interrupt is not yet due we run
+//	whole basic blocks (see RunBlock), and advance the clock ourselves.
+//	Each interrupt still fires at exactly the tick it would have.
+//	We don't batch when single stepping, or tracing every tick or
+//	every memory access.
 //----------------------------------------------------------------------
 
 void
 Machine::Run()
 {
-    Instruction *instr = new Instruction;  // storage for decoded instruction
+    Interrupt *interrupt = kernel->interrupt;
+    Statistics *stats = kernel->stats;
 
     if (debug->IsEnabled('m')) {
         cout << "Starting program in thread: " << kernel->currentThread->getName();
@@ -64,8 +69,15 @@ Machine::Run()
     }
     kernel->interrupt->setStatus(UserMode);
     for (;;) {
+	if (!singleStep && !debug->IsEnabled(dbgTraCode)
+		&& !debug->IsEnabled(dbgInt) && !debug->IsEnabled(dbgAddr)) {
+	    while (interrupt->QuietUntil(stats->totalTicks + UserTick)) {
+		RunBlock((interrupt->NextDue() - 1 - stats->totalTicks)
+								/ UserTick);
+	    }
+	}
 	DEBUG(dbgTraCode, "In Machine::Run(), into OneInstruction " << "== Tick " << kernel->stats->totalTicks << " ==");
-        OneInstruction(instr);
+        OneInstruction();
 	DEBUG(dbgTraCode, "In Machine::Run(), return from OneInstruction  " << "== Tick " << kernel->stats->totalTicks << " ==");
 		
 	DEBUG(dbgTraCode, "In Machine::Run(), into OneTick " << "== Tick " << kernel->stats->totalTicks << " ==");
@@ -119,27 +131,131 @@ TypeToReg(RegType reg, Instruction *instr)
 //	store all data back to the machine registers and memory before
 //	leaving.  This allows the Nachos kernel to control our behavior
 //	by controlling the contents of memory, the translation table,
-//	and the register set.
+//	and the register set.  (The one exception is decoded instructions,
+//	which FetchInstruction throws away whenever memory changes.)
 //----------------------------------------------------------------------
 
 void
-Machine::OneInstruction(Instruction *instr)
+Machine::OneInstruction()
+{
+    Instruction *instr;
+
+    // Fetch instruction, already decoded
+    if ((instr = FetchInstruction(registers[PCReg])) == NULL)
+	return;			// exception occurred
+    Execute(instr, 1);
+}
+
+//----------------------------------------------------------------------
+// Machine::RunBlock
+// 	Run user instructions from the PC to the end of their basic block
+//	(see FetchInstruction), but no more than "maxSteps" of them, and
+//	charge UserTick for each, as Run and OneTick would have.
+//
+//	Only the first instruction is translated; the rest follow it in
+//	the same page, so they are there, already decoded, and Execute
+//	runs them one after the other (it stops early when it must).
+//
+//	The clock is advanced once, at the end, but before a trap we
+//	bring it up to date (see RaiseException), so the kernel always
+//	sees the time it would have.  After a trap, the kernel may have
+//	moved the clock or scheduled interrupts, so the trapping
+//	instruction's tick goes through OneTick, as Run would do it, and
+//	anything now due fires on time.
+//
+//	"maxSteps" -- how many instructions we can run before the next
+//		interrupt is due; at least 1
+//----------------------------------------------------------------------
+
+void
+Machine::RunBlock(int maxSteps)
+{
+    Statistics *stats = kernel->stats;
+    Instruction *instr = FetchInstruction(registers[PCReg]);
+
+    ASSERT(blockTicks == 0 && maxSteps >= 1);
+    if (instr == NULL) {		// the fetch trapped
+	kernel->interrupt->OneTick();
+	return;
+    }
+    if (maxSteps > instr->blockLength) {
+	maxSteps = instr->blockLength;
+    }
+    trapped = FALSE;
+    Execute(instr, maxSteps);
+    if (trapped) {
+	ASSERT(blockTicks == 0);	// RaiseException charged them
+	kernel->interrupt->OneTick();
+	return;
+    }
+    blockTicks += UserTick;		// for the last one run
+    stats->totalTicks += blockTicks;
+    stats->userTicks += blockTicks;
+    blockTicks = 0;
+}
+
+//----------------------------------------------------------------------
+// Machine::Execute
+// 	Carry out fetched and decoded user instructions; OneInstruction
+//	without the fetch.  Run "instr", then the ones after it in its
+//	page, but no more than "maxSteps" in all.  We stop early if an
+//	instruction traps to the kernel, or doesn't go on to the next
+//	one -- the kernel may have changed anything -- or if the page is
+//	written to.
+//
+//	Each instruction run but the last is charged UserTick in
+//	blockTicks; the caller charges for the last (see RunBlock).
+//
+//	With DIRECT_DISPATCH, Execute(NULL, 0) only sets opHandlers,
+//	which FetchInstruction copies into each instruction it decodes.
+//----------------------------------------------------------------------
+
+void
+Machine::Execute(Instruction *instr, int maxSteps)
 {
 #ifdef SIM_FIX
     int byte;       // described in Kane for LWL,LWR,...
 #endif
 
-    int raw;
-    int nextLoadReg = 0; 	
-    int nextLoadValue = 0; 	// record delayed load operation, to apply
+    int nextLoadReg; 	
+    int nextLoadValue; 		// record delayed load operation, to apply
 				// in the future
+    int pcAfter;
+    int sum, diff, tmp, value;
+    unsigned int rs, rt, imm;
+    int frame = 0;
+    int pc = registers[PCReg];
 
-    // Fetch instruction 
-    if (!ReadMem(registers[PCReg], 4, &raw))
-	return;			// exception occurred
-    instr->value = raw;
-    instr->Decode();
+#ifdef DIRECT_DISPATCH
+    static void *handlers[MaxOpcode + 1] = {	// indexed by opCode
+	&&L_default, &&L_OP_ADD, &&L_OP_ADDI, &&L_OP_ADDIU,
+	&&L_OP_ADDU, &&L_OP_AND, &&L_OP_ANDI, &&L_OP_BEQ,
+	&&L_OP_BGEZ, &&L_OP_BGEZAL, &&L_OP_BGTZ, &&L_OP_BLEZ,
+	&&L_OP_BLTZ, &&L_OP_BLTZAL, &&L_OP_BNE, &&L_default,
+	&&L_OP_DIV, &&L_OP_DIVU, &&L_OP_J, &&L_OP_JAL,
+	&&L_OP_JALR, &&L_OP_JR, &&L_OP_LB, &&L_OP_LBU,
+	&&L_OP_LH, &&L_OP_LHU, &&L_OP_LUI, &&L_OP_LW,
+	&&L_OP_LWL, &&L_OP_LWR, &&L_default, &&L_OP_MFHI,
+	&&L_OP_MFLO, &&L_default, &&L_OP_MTHI, &&L_OP_MTLO,
+	&&L_OP_MULT, &&L_OP_MULTU, &&L_OP_NOR, &&L_OP_OR,
+	&&L_OP_ORI, &&L_default, &&L_OP_SB, &&L_OP_SH,
+	&&L_OP_SLL, &&L_OP_SLLV, &&L_OP_SLT, &&L_OP_SLTI,
+	&&L_OP_SLTIU, &&L_OP_SLTU, &&L_OP_SRA, &&L_OP_SRAV,
+	&&L_OP_SRL, &&L_OP_SRLV, &&L_OP_SUB, &&L_OP_SUBU,
+	&&L_OP_SW, &&L_OP_SWL, &&L_OP_SWR, &&L_OP_XOR,
+	&&L_OP_XORI, &&L_OP_SYSCALL, &&L_OP_UNIMP, &&L_OP_RES
+    };
 
+    if (instr == NULL) {
+	opHandlers = handlers;
+	return;
+    }
+#endif
+    if (maxSteps > 1) {
+	frame = (instr - decoded) / InstrsPerPage;
+    }
+
+  next:
     if (debug->IsEnabled('m')) {
         struct OpString *str = &opStrings[instr->opCode];
 	char buf[80];
@@ -151,15 +267,18 @@ Machine::OneInstruction(Instruction *instr)
         cout << "\t" << buf << "\n";
     }
     
+    nextLoadReg = 0;
+    nextLoadValue = 0;
     // Compute next pc, but don't install in case there's an error or branch.
-    int pcAfter = registers[NextPCReg] + 4;
-    int sum, diff, tmp, value;
-    unsigned int rs, rt, imm;
+    pcAfter = registers[NextPCReg] + 4;
 
     // Execute the instruction (cf. Kane's book)
+#ifdef DIRECT_DISPATCH
+    goto *instr->handler;
+#endif
     switch (instr->opCode) {
 	
-      case OP_ADD:
+      OPCASE(OP_ADD)
 	sum = registers[instr->rs] + registers[instr->rt];
 	if (!((registers[instr->rs] ^ registers[instr->rt]) & SIGN_BIT) &&
 	    ((registers[instr->rs] ^ sum) & SIGN_BIT)) {
@@ -169,7 +288,7 @@ Machine::OneInstruction(Instruction *instr)
 	registers[instr->rd] = sum;
 	break;
 	
-      case OP_ADDI:
+      OPCASE(OP_ADDI)
 	sum = registers[instr->rs] + instr->extra;
 	if (!((registers[instr->rs] ^ instr->extra) & SIGN_BIT) &&
 	    ((instr->extra ^ sum) & SIGN_BIT)) {
@@ -179,57 +298,57 @@ Machine::OneInstruction(Instruction *instr)
 	registers[instr->rt] = sum;
 	break;
 	
-      case OP_ADDIU:
+      OPCASE(OP_ADDIU)
 	registers[instr->rt] = registers[instr->rs] + instr->extra;
 	break;
 	
-      case OP_ADDU:
+      OPCASE(OP_ADDU)
 	registers[instr->rd] = registers[instr->rs] + registers[instr->rt];
 	break;
 	
-      case OP_AND:
+      OPCASE(OP_AND)
 	registers[instr->rd] = registers[instr->rs] & registers[instr->rt];
 	break;
 	
-      case OP_ANDI:
+      OPCASE(OP_ANDI)
 	registers[instr->rt] = registers[instr->rs] & (instr->extra & 0xffff);
 	break;
 	
-      case OP_BEQ:
+      OPCASE(OP_BEQ)
 	if (registers[instr->rs] == registers[instr->rt])
 	    pcAfter = registers[NextPCReg] + IndexToAddr(instr->extra);
 	break;
 	
-      case OP_BGEZAL:
+      OPCASE(OP_BGEZAL)
 	registers[R31] = registers[NextPCReg] + 4;
-      case OP_BGEZ:
+      OPCASE(OP_BGEZ)
 	if (!(registers[instr->rs] & SIGN_BIT))
 	    pcAfter = registers[NextPCReg] + IndexToAddr(instr->extra);
 	break;
 	
-      case OP_BGTZ:
+      OPCASE(OP_BGTZ)
 	if (registers[instr->rs] > 0)
 	    pcAfter = registers[NextPCReg] + IndexToAddr(instr->extra);
 	break;
 	
-      case OP_BLEZ:
+      OPCASE(OP_BLEZ)
 	if (registers[instr->rs] <= 0)
 	    pcAfter = registers[NextPCReg] + IndexToAddr(instr->extra);
 	break;
 	
-      case OP_BLTZAL:
+      OPCASE(OP_BLTZAL)
 	registers[R31] = registers[NextPCReg] + 4;
-      case OP_BLTZ:
+      OPCASE(OP_BLTZ)
 	if (registers[instr->rs] & SIGN_BIT)
 	    pcAfter = registers[NextPCReg] + IndexToAddr(instr->extra);
 	break;
 	
-      case OP_BNE:
+      OPCASE(OP_BNE)
 	if (registers[instr->rs] != registers[instr->rt])
 	    pcAfter = registers[NextPCReg] + IndexToAddr(instr->extra);
 	break;
 	
-      case OP_DIV:
+      OPCASE(OP_DIV)
 	if (registers[instr->rt] == 0) {
 	    registers[LoReg] = 0;
 	    registers[HiReg] = 0;
@@ -239,7 +358,7 @@ Machine::OneInstruction(Instruction *instr)
 	}
 	break;
 	
-      case OP_DIVU:	  
+      OPCASE(OP_DIVU)
 	  rs = (unsigned int) registers[instr->rs];
 	  rt = (unsigned int) registers[instr->rt];
 	  if (rt == 0) {
@@ -253,20 +372,20 @@ Machine::OneInstruction(Instruction *instr)
 	  }
 	  break;
 	
-      case OP_JAL:
+      OPCASE(OP_JAL)
 	registers[R31] = registers[NextPCReg] + 4;
-      case OP_J:
+      OPCASE(OP_J)
 	pcAfter = (pcAfter & 0xf0000000) | IndexToAddr(instr->extra);
 	break;
 	
-      case OP_JALR:
+      OPCASE(OP_JALR)
 	registers[instr->rd] = registers[NextPCReg] + 4;
-      case OP_JR:
+      OPCASE(OP_JR)
 	pcAfter = registers[instr->rs];
 	break;
 	
-      case OP_LB:
-      case OP_LBU:
+      OPCASE(OP_LB)
+      OPCASE(OP_LBU)
 	tmp = registers[instr->rs] + instr->extra;
 	if (!ReadMem(tmp, 1, &value))
 	    return;
@@ -279,8 +398,8 @@ Machine::OneInstruction(Instruction *instr)
 	nextLoadValue = value;
 	break;
 	
-      case OP_LH:
-      case OP_LHU:	  
+      OPCASE(OP_LH)
+      OPCASE(OP_LHU)
 	tmp = registers[instr->rs] + instr->extra;
 	if (tmp & 0x1) {
 	    RaiseException(AddressErrorException, tmp);
@@ -297,12 +416,12 @@ Machine::OneInstruction(Instruction *instr)
 	nextLoadValue = value;
 	break;
       	
-      case OP_LUI:
+      OPCASE(OP_LUI)
 	DEBUG(dbgMach, "Executing: LUI r" << instr->rt << ", " << instr->extra);
 	registers[instr->rt] = instr->extra << 16;
 	break;
 	
-      case OP_LW:
+      OPCASE(OP_LW)
 	tmp = registers[instr->rs] + instr->extra;
 	if (tmp & 0x3) {
 	    RaiseException(AddressErrorException, tmp);
@@ -314,7 +433,7 @@ Machine::OneInstruction(Instruction *instr)
 	nextLoadValue = value;
 	break;
     	
-      case OP_LWL:	  
+      OPCASE(OP_LWL)
 	tmp = registers[instr->rs] + instr->extra;
 
 #ifdef SIM_FIX
@@ -366,7 +485,7 @@ Machine::OneInstruction(Instruction *instr)
 	nextLoadReg = instr->rt;
 	break;
       	
-      case OP_LWR:
+      OPCASE(OP_LWR)
 	tmp = registers[instr->rs] + instr->extra;
 
 #ifdef SIM_FIX
@@ -422,80 +541,80 @@ Machine::OneInstruction(Instruction *instr)
 	nextLoadReg = instr->rt;
 	break;
     	
-      case OP_MFHI:
+      OPCASE(OP_MFHI)
 	registers[instr->rd] = registers[HiReg];
 	break;
 	
-      case OP_MFLO:
+      OPCASE(OP_MFLO)
 	registers[instr->rd] = registers[LoReg];
 	break;
 	
-      case OP_MTHI:
+      OPCASE(OP_MTHI)
 	registers[HiReg] = registers[instr->rs];
 	break;
 	
-      case OP_MTLO:
+      OPCASE(OP_MTLO)
 	registers[LoReg] = registers[instr->rs];
 	break;
 	
-      case OP_MULT:
+      OPCASE(OP_MULT)
 	Mult(registers[instr->rs], registers[instr->rt], TRUE,
 	     &registers[HiReg], &registers[LoReg]);
 	break;
 	
-      case OP_MULTU:
+      OPCASE(OP_MULTU)
 	Mult(registers[instr->rs], registers[instr->rt], FALSE,
 	     &registers[HiReg], &registers[LoReg]);
 	break;
 	
-      case OP_NOR:
+      OPCASE(OP_NOR)
 	registers[instr->rd] = ~(registers[instr->rs] | registers[instr->rt]);
 	break;
 	
-      case OP_OR:
+      OPCASE(OP_OR)
 	registers[instr->rd] = registers[instr->rs] | registers[instr->rt];
 	break;
 	
-      case OP_ORI:
+      OPCASE(OP_ORI)
 	registers[instr->rt] = registers[instr->rs] | (instr->extra & 0xffff);
 	break;
 	
-      case OP_SB:
+      OPCASE(OP_SB)
 	if (!WriteMem((unsigned) 
 		(registers[instr->rs] + instr->extra), 1, registers[instr->rt]))
 	    return;
 	break;
 	
-      case OP_SH:
+      OPCASE(OP_SH)
 	if (!WriteMem((unsigned) 
 		(registers[instr->rs] + instr->extra), 2, registers[instr->rt]))
 	    return;
 	break;
 	
-      case OP_SLL:
+      OPCASE(OP_SLL)
 	registers[instr->rd] = registers[instr->rt] << instr->extra;
 	break;
 	
-      case OP_SLLV:
+      OPCASE(OP_SLLV)
 	registers[instr->rd] = registers[instr->rt] <<
 	    (registers[instr->rs] & 0x1f);
 	break;
 	
-      case OP_SLT:
+      OPCASE(OP_SLT)
 	if (registers[instr->rs] < registers[instr->rt])
 	    registers[instr->rd] = 1;
 	else
 	    registers[instr->rd] = 0;
 	break;
 	
-      case OP_SLTI:
+      OPCASE(OP_SLTI)
 	if (registers[instr->rs] < instr->extra)
 	    registers[instr->rt] = 1;
 	else
 	    registers[instr->rt] = 0;
 	break;
 	
-      case OP_SLTIU:	  
+      OPCASE(OP_SLTIU)
 	rs = registers[instr->rs];
 	imm = instr->extra;
 	if (rs < imm)
@@ -504,7 +623,7 @@ Machine::OneInstruction(Instruction *instr)
 	    registers[instr->rt] = 0;
 	break;
       	
-      case OP_SLTU:	  
+      OPCASE(OP_SLTU)
 	rs = registers[instr->rs];
 	rt = registers[instr->rt];
 	if (rs < rt)
@@ -513,28 +632,28 @@ Machine::OneInstruction(Instruction *instr)
 	    registers[instr->rd] = 0;
 	break;
       	
-      case OP_SRA:
+      OPCASE(OP_SRA)
 	registers[instr->rd] = registers[instr->rt] >> instr->extra;
 	break;
 	
-      case OP_SRAV:
+      OPCASE(OP_SRAV)
 	registers[instr->rd] = registers[instr->rt] >>
 	    (registers[instr->rs] & 0x1f);
 	break;
 	
-      case OP_SRL:
+      OPCASE(OP_SRL)
 	tmp = registers[instr->rt];
 	tmp >>= instr->extra;
 	registers[instr->rd] = tmp;
 	break;
 	
-      case OP_SRLV:
+      OPCASE(OP_SRLV)
 	tmp = registers[instr->rt];
 	tmp >>= (registers[instr->rs] & 0x1f);
 	registers[instr->rd] = tmp;
 	break;
 	
-      case OP_SUB:	  
+      OPCASE(OP_SUB)
 	diff = registers[instr->rs] - registers[instr->rt];
 	if (((registers[instr->rs] ^ registers[instr->rt]) & SIGN_BIT) &&
 	    ((registers[instr->rs] ^ diff) & SIGN_BIT)) {
@@ -544,17 +663,17 @@ Machine::OneInstruction(Instruction *instr)
 	registers[instr->rd] = diff;
 	break;
       	
-      case OP_SUBU:
+      OPCASE(OP_SUBU)
 	registers[instr->rd] = registers[instr->rs] - registers[instr->rt];
 	break;
 	
-      case OP_SW:
+      OPCASE(OP_SW)
 	if (!WriteMem((unsigned) 
 		(registers[instr->rs] + instr->extra), 4, registers[instr->rt]))
 	    return;
 	break;
 	
-      case OP_SWL:	  
+      OPCASE(OP_SWL)
 	tmp = registers[instr->rs] + instr->extra;
 
 #ifdef SIM_FIX
@@ -613,7 +732,7 @@ Machine::OneInstruction(Instruction *instr)
 #endif // SIM_FIX
 	break;
     	
-      case OP_SWR:	  
+      OPCASE(OP_SWR)
 	tmp = registers[instr->rs] + instr->extra;
 
 #ifndef SIM_FIX
@@ -672,25 +791,25 @@ Machine::OneInstruction(Instruction *instr)
 
 	break;
     	
-      case OP_SYSCALL:
+      OPCASE(OP_SYSCALL)
 	DEBUG(dbgTraCode, "In Machine::OneInstruction, RaiseException(SyscallException, 0), " << kernel->stats->totalTicks);
 	RaiseException(SyscallException, 0);
 	return; 
 	
-      case OP_XOR:
+      OPCASE(OP_XOR)
 	registers[instr->rd] = registers[instr->rs] ^ registers[instr->rt];
 	break;
 	
-      case OP_XORI:
+      OPCASE(OP_XORI)
 	registers[instr->rt] = registers[instr->rs] ^ (instr->extra & 0xffff);
 	break;
 	
-      case OP_RES:
-      case OP_UNIMP:
+      OPCASE(OP_RES)
+      OPCASE(OP_UNIMP)
 	RaiseException(IllegalInstrException, 0);
 	return;
 	
-      default:
+      OPDEFAULT
 	ASSERT(FALSE);
     }
     
@@ -704,6 +823,16 @@ Machine::OneInstruction(Instruction *instr)
 						// are jumping into lala-land
     registers[PCReg] = registers[NextPCReg];
     registers[NextPCReg] = pcAfter;
+
+    // Go straight on to the next instruction, if we can.
+    pc += 4;
+    if (--maxSteps == 0 || trapped || registers[PCReg] != pc
+					|| !pageDecoded[frame]) {
+	return;
+    }
+    blockTicks += UserTick;
+    instr++;
+    goto next;
 }
 
 //----------------------------------------------------------------------
@@ -723,6 +852,107 @@ Machine::DelayedLoad(int nextReg, int nextValue)
     registers[0] = 0; 	// and always make sure R0 stays zero.
 }
 
+//----------------------------------------------------------------------
+// EndsBlock
+// 	Return how many instructions, from one with "opCode", there are to
+//	the end of its basic block, if it ends one: 2 for a branch or jump
+//	(the delay slot is run before control moves), 1 for an instruction
+//	that always traps to the kernel.  Return 0 if it does not end one.
+//----------------------------------------------------------------------
+
+static int
+EndsBlock(int opCode)
+{
+    switch (opCode) {
+      case OP_BEQ: case OP_BGEZ: case OP_BGEZAL: case OP_BGTZ:
+      case OP_BLEZ: case OP_BLTZ: case OP_BLTZAL: case OP_BNE:
+      case OP_J: case OP_JAL: case OP_JALR: case OP_JR:
+	return 2;
+      case OP_SYSCALL: case OP_UNIMP: case OP_RES:
+	return 1;
+      default:
+	return 0;
+    }
+}
+
+//----------------------------------------------------------------------
+// Machine::FetchInstruction
+//	Read the instruction at virtual address "addr", as ReadMem would,
+//	and return it decoded, or NULL if there was an exception.
+//
+//	Decoding is done a physical page at a time, the first time we
+//	run an instruction from the page, and kept until the page is
+//	written to -- by the program (see WriteMem), or by the kernel
+//	(see InvalidateDecoded).  Loops then run without decoding the
+//	same words over and over.  The decoded page is kept by physical
+//	address, so it is good whichever address space maps it.
+//
+//	With DIRECT_DISPATCH, each instruction is also given the address
+//	of the code in Execute for its opcode.
+//
+//	While decoding, we also find the basic blocks in the page: each
+//	instruction is given the number of instructions from it to the
+//	end of its block, which is a branch or jump and its delay slot,
+//	an instruction that traps to the kernel, or the end of the page.
+//
+//	The result must not be changed; it is the copy in the cache.
+//----------------------------------------------------------------------
+
+Instruction *
+Machine::FetchInstruction(int addr)
+{
+    ExceptionType exception;
+    int physicalAddress;
+    char *hostAddr;
+    int frame;
+    Instruction *instr;
+
+    if ((addr & 0x3) == 0 && (hostAddr = readCache.Lookup(addr)) != NULL) {
+	physicalAddress = hostAddr - mainMemory;
+    } else {
+	DEBUG(dbgAddr, "Reading VA " << addr << ", size 4");
+
+	exception = Translate(addr, &physicalAddress, 4, FALSE);
+	if (exception != NoException) {
+	    RaiseException(exception, addr);
+	    return NULL;
+	}
+	CacheTranslation(addr, physicalAddress, FALSE);
+    }
+    frame = physicalAddress >> PageShift;
+    if (!pageDecoded[frame]) {		// decode the whole page
+	unsigned int *word = (unsigned int *) &mainMemory[frame << PageShift];
+
+	instr = &decoded[frame * InstrsPerPage];
+#ifdef DIRECT_DISPATCH
+	if (opHandlers == NULL) {
+	    Execute(NULL, 0);
+	}
+#endif
+	for (int i = 0; i < InstrsPerPage; i++) {
+	    instr[i].value = WordToHost(word[i]);
+	    instr[i].Decode();
+#ifdef DIRECT_DISPATCH
+	    instr[i].handler = opHandlers[(int) instr[i].opCode];
+#endif
+	}
+	for (int i = InstrsPerPage - 1; i >= 0; i--) {
+	    if (i == InstrsPerPage - 1 || EndsBlock(instr[i].opCode) == 1) {
+		instr[i].blockLength = 1;
+	    } else if (EndsBlock(instr[i].opCode) == 2) {
+		instr[i].blockLength = 2;	// and the delay slot
+	    } else {
+		instr[i].blockLength = instr[i + 1].blockLength + 1;
+	    }
+	}
+	pageDecoded[frame] = TRUE;
+    }
+    instr = &decoded[physicalAddress / 4];
+
+    DEBUG(dbgAddr, "\tvalue read = " << (int) instr->value);
+    return instr;
+}
+
 //----------------------------------------------------------------------
 // Instruction::Decode
 // 	Decode a MIPS instruction 
@@ -168,7 +168,8 @@ NetworkOutput::Send(PacketHeader hdr, char* data)
 
     kernel->interrupt->Schedule(this, NetworkTime, NetworkSendInt);
 
-    if (RandomNumber() % 100 >= chanceToWork * 100) { // emulate a lost packet
+    if (kernel->replay->Input(ReplayRandom, RandomNumber() % 100)
+				>= chanceToWork * 100) { // emulate a lost packet
 	DEBUG(dbgNet, "oops, lost it!");
 	return;
     }
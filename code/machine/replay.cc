@@ -0,0 +1,192 @@
+// replay.cc
+//	Routines to record the nondeterministic inputs of a run, and
+//	the scheduling decisions made, and to replay them.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "debug.h"
+#include "replay.h"
+#include "main.h"
+
+static char *kindName[] = { "timer delay", "random number", "console input",
+				"disk latency", "thread run" };
+
+//----------------------------------------------------------------------
+// ReplayLog::ReplayLog
+//	Open the log, to record to or replay from.
+//
+//	"mode" is whether to record, replay, or neither
+//	"fileName" is the log; ignored if "mode" is ReplayOff
+//----------------------------------------------------------------------
+
+ReplayLog::ReplayLog(ReplayMode mode, char *fileName)
+{
+    this->mode = mode;
+    buffer = new ReplayEntry[ReplayBufferSize];
+    numBuffered = 0;
+    position = 0;
+    numInputs = 0;
+    numRuns = 0;
+    if (mode == ReplayRecording) {
+	fd = OpenForWrite(fileName);
+    } else if (mode == ReplayPlayback) {
+	fd = OpenForReadWrite(fileName, TRUE);
+    } else {
+	fd = -1;
+    }
+}
+
+//----------------------------------------------------------------------
+// ReplayLog::~ReplayLog
+//	Write out what is left of the log, and close it.
+//----------------------------------------------------------------------
+
+ReplayLog::~ReplayLog()
+{
+    if (mode == ReplayRecording && numBuffered > 0) {
+	WriteFile(fd, (char *) buffer, numBuffered * sizeof(ReplayEntry));
+    }
+    if (fd >= 0) {
+	Close(fd);
+    }
+    delete [] buffer;
+}
+
+//----------------------------------------------------------------------
+// ReplayLog::Log
+//	Add a record to the log, writing out the buffer when it fills.
+//----------------------------------------------------------------------
+
+void
+ReplayLog::Log(ReplayKind kind, int value)
+{
+    ReplayEntry *record = &buffer[numBuffered++];
+
+    record->tick = kernel->stats->totalTicks;
+    record->value = value;
+    record->kind = kind;
+    if (numBuffered == ReplayBufferSize) {
+	WriteFile(fd, (char *) buffer, numBuffered * sizeof(ReplayEntry));
+	numBuffered = 0;
+    }
+}
+
+//----------------------------------------------------------------------
+// ReplayLog::Next
+//	Return the next record in the log, reading more of it if need
+//	be.  It must be of "kind", and for the current tick: otherwise
+//	the replay has gone off the rails.
+//----------------------------------------------------------------------
+
+ReplayEntry *
+ReplayLog::Next(ReplayKind kind)
+{
+    ReplayEntry *record;
+
+    if (position == numBuffered) {
+	int n = ReadPartial(fd, (char *) buffer,
+				ReplayBufferSize * sizeof(ReplayEntry));
+
+	numBuffered = n > 0 ? n / sizeof(ReplayEntry) : 0;
+	position = 0;
+	if (numBuffered == 0) {
+	    cerr << "Replay log ended; wanted a " << kindName[kind] << "\n";
+	    Diverged("event", -1, kind);
+	}
+    }
+    record = &buffer[position++];
+    if (record->kind != kind) {
+	cerr << "Replay log has a " << kindName[record->kind]
+	     << "; wanted a " << kindName[kind] << "\n";
+	Diverged("event", record->kind, kind);
+    }
+    if (record->tick != kernel->stats->totalTicks) {
+	Diverged("tick", record->tick, kernel->stats->totalTicks);
+    }
+    return record;
+}
+
+//----------------------------------------------------------------------
+// ReplayLog::Diverged
+//	The replay does not match the log; say how, and give up.
+//
+//	"what" is what was different; "logged" and "live" the values
+//----------------------------------------------------------------------
+
+void
+ReplayLog::Diverged(char *what, int logged, int live)
+{
+    cerr << "Replay diverged at tick " << kernel->stats->totalTicks
+	 << ", after " << numInputs << " inputs and " << numRuns
+	 << " switches: " << what << " was " << logged << " in the log, "
+	 << live << " now\n";
+    Abort();
+}
+
+//----------------------------------------------------------------------
+// ReplayLog::Input
+//	A device, or the kernel, needs a nondeterministic input.  When
+//	recording, log the live value; when replaying, use the logged
+//	one instead.  Return the value to use.
+//
+//	"kind" is what sort of input it is
+//	"value" is the live value; ignored when replaying
+//----------------------------------------------------------------------
+
+int
+ReplayLog::Input(ReplayKind kind, int value)
+{
+    if (mode == ReplayOff) {
+	return value;
+    }
+    numInputs++;
+    if (mode == ReplayRecording) {
+	Log(kind, value);
+	return value;
+    }
+    return Next(kind)->value;
+}
+
+//----------------------------------------------------------------------
+// ReplayLog::Ran
+//	The scheduler is switching to thread "threadID".  When recording,
+//	log it; when replaying, check the log made the same choice.
+//----------------------------------------------------------------------
+
+void
+ReplayLog::Ran(int threadID)
+{
+    if (mode == ReplayOff) {
+	return;
+    }
+    numRuns++;
+    if (mode == ReplayRecording) {
+	Log(ReplayRun, threadID);
+    } else {
+	int logged = Next(ReplayRun)->value;
+
+	if (logged != threadID) {
+	    Diverged(kindName[ReplayRun], logged, threadID);
+	}
+    }
+}
+
+//----------------------------------------------------------------------
+// ReplayLog::Print
+//	Print how many inputs and switches were logged, or replayed.
+//----------------------------------------------------------------------
+
+void
+ReplayLog::Print()
+{
+    if (mode == ReplayRecording) {
+	cout << "Replay: recorded " << numInputs << " inputs, " << numRuns
+	     << " switches\n";
+    } else if (mode == ReplayPlayback) {
+	cout << "Replay: replayed " << numInputs << " inputs, " << numRuns
+	     << " switches matched\n";
+    }
+}
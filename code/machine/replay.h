@@ -0,0 +1,82 @@
+// replay.h
+//	Data structures to record, and replay, a run of Nachos.
+//
+//	Nachos is deterministic, except for a few inputs: the random
+//	delays of the timer (with "-rs"), other random choices (lottery
+//	scheduling, lost network packets), when console input shows up
+//	and what it is, and how long the disk takes.  With
+//	"-record <file>", each of these is logged as it is used, along
+//	with every thread the scheduler switches to.  With
+//	"-replay <file>", the logged values are used instead of the live
+//	ones, and every switch is checked against the log; if the run
+//	takes a different turn, we say where, and abort.
+//
+//	A replay must be run with the same command line as the
+//	recording (less -record): the flags decide which inputs are
+//	asked for.
+//
+//	The log is a sequence of fixed-size binary records, in the
+//	host's byte order.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "copyright.h"
+#include "utility.h"
+
+// The kinds of things we log.
+enum ReplayKind { ReplayTimer,		// a random timer delay
+		  ReplayRandom,		// any other random number
+		  ReplayConsole,	// a poll of the console input
+		  ReplayDisk,		// a disk request's latency
+		  ReplayRun		// the thread the scheduler ran
+};
+
+enum ReplayMode { ReplayOff, ReplayRecording, ReplayPlayback };
+
+class ReplayEntry {
+  public:
+    int tick;			// when it happened
+    int value;			// the input, or the ID of the thread run
+    int kind;			// a ReplayKind
+};
+
+const int ReplayBufferSize = 256;	// records read or written at once
+
+class ReplayLog {
+  public:
+    ReplayLog(ReplayMode mode, char *fileName);
+				// record to, or replay from, "fileName"
+    ~ReplayLog();		// write out the last of the log
+
+    bool Replaying() { return mode == ReplayPlayback; }
+
+    int Input(ReplayKind kind, int value);
+				// a nondeterministic input; "value" is
+				// the live one.  Returns the one to use.
+    void Ran(int threadID);	// the scheduler is switching to
+				// thread "threadID"
+    void Print();		// print how much was logged or checked
+
+  private:
+    ReplayMode mode;
+    int fd;			// the log file, or -1
+    ReplayEntry *buffer;	// records on their way to or from it
+    int numBuffered;		// records in buffer
+    int position;		// the next to replay from buffer
+    int numInputs;		// inputs logged or replayed so far
+    int numRuns;		// switches logged or checked so far
+
+    void Log(ReplayKind kind, int value);
+    ReplayEntry *Next(ReplayKind kind);
+				// the next record in the log, which
+				// had better be of "kind"
+    void Diverged(char *what, int logged, int live);
+				// the replay went wrong; say how
+};
+
+#endif // REPLAY_H
@@ -22,6 +22,8 @@ Statistics::Statistics()
     numDiskReads = numDiskWrites = 0;
     numConsoleCharsRead = numConsoleCharsWritten = 0;
     numPageFaults = numPacketsSent = numPacketsRecvd = 0;
+    numPageOuts = numPageWrites = 0;
+    pagingPolicy = NULL;
 }
 
 //----------------------------------------------------------------------
@@ -39,7 +41,12 @@ Statistics::Print()
 		cout << ", writes " << numDiskWrites << "\n";
 		cout << "Console I/O: reads " << numConsoleCharsRead;
     cout << ", writes " << numConsoleCharsWritten << "\n";
-    cout << "Paging: faults " << numPageFaults << "\n";
+    cout << "Paging: faults " << numPageFaults;
+    if (pagingPolicy != NULL) {
+	cout << ", page outs " << numPageOuts << ", write-backs "
+		<< numPageWrites << " (" << pagingPolicy << ")";
+    }
+    cout << "\n";
     cout << "Network I/O: packets received " << numPacketsRecvd;
 		cout << ", sent " << numPacketsSent << "\n";
 }
@@ -33,6 +33,10 @@ class Statistics {
     int numConsoleCharsRead;	// number of characters read from the keyboard
     int numConsoleCharsWritten; // number of characters written to the display
     int numPageFaults;		// number of virtual memory page faults
+    int numPageOuts;		// number of pages taken out of memory
+    int numPageWrites;		// number of pages written to swap
+    char *pagingPolicy;		// the page replacement policy; NULL
+				// without demand paging
     int numPacketsSent;		// number of packets sent over the network
     int numPacketsRecvd;	// number of packets received over the network
 
@@ -74,6 +74,7 @@ Timer::SetInterrupt()
     
        if (randomize) {
 	     delay = 1 + (RandomNumber() % (TimerTicks * 2));
+	     delay = kernel->replay->Input(ReplayTimer, delay);
         }
        // schedule the next timer device interrupt
        kernel->interrupt->Schedule(this, delay, TimerInt);
@@ -88,27 +88,35 @@ Machine::ReadMem(int addr, int size, int *value)
     int data;
     ExceptionType exception;
     int physicalAddress;
+    char *hostAddr = NULL;
     
-    DEBUG(dbgAddr, "Reading VA " << addr << ", size " << size);
+    if ((addr & (size - 1)) == 0) {	// aligned, so it may be cached
+	hostAddr = readCache.Lookup(addr);
+    }
+    if (hostAddr == NULL) {
+	DEBUG(dbgAddr, "Reading VA " << addr << ", size " << size);
     
-    exception = Translate(addr, &physicalAddress, size, FALSE);
-    if (exception != NoException) {
-	RaiseException(exception, addr);
-	return FALSE;
+	exception = Translate(addr, &physicalAddress, size, FALSE);
+	if (exception != NoException) {
+	    RaiseException(exception, addr);
+	    return FALSE;
+	}
+	CacheTranslation(addr, physicalAddress, FALSE);
+	hostAddr = &mainMemory[physicalAddress];
     }
     switch (size) {
       case 1:
-	data = mainMemory[physicalAddress];
+	data = *hostAddr;
 	*value = data;
 	break;
 	
       case 2:
-	data = *(unsigned short *) &mainMemory[physicalAddress];
+	data = *(unsigned short *) hostAddr;
 	*value = ShortToHost(data);
 	break;
 	
       case 4:
-	data = *(unsigned int *) &mainMemory[physicalAddress];
+	data = *(unsigned int *) hostAddr;
 	*value = WordToHost(data);
 	break;
 
@@ -137,26 +145,36 @@ Machine::WriteMem(int addr, int size, int value)
 {
     ExceptionType exception;
     int physicalAddress;
+    char *hostAddr = NULL;
      
-    DEBUG(dbgAddr, "Writing VA " << addr << ", size " << size << ", value " << value);
+    if ((addr & (size - 1)) == 0) {	// aligned, so it may be cached
+	hostAddr = writeCache.Lookup(addr);
+    }
+    if (hostAddr == NULL) {
+	DEBUG(dbgAddr, "Writing VA " << addr << ", size " << size << ", value " << value);
 
-    exception = Translate(addr, &physicalAddress, size, TRUE);
-    if (exception != NoException) {
-	RaiseException(exception, addr);
-	return FALSE;
+	exception = Translate(addr, &physicalAddress, size, TRUE);
+	if (exception != NoException) {
+	    RaiseException(exception, addr);
+	    return FALSE;
+	}
+	CacheTranslation(addr, physicalAddress, TRUE);
+	hostAddr = &mainMemory[physicalAddress];
     }
+    pageDecoded[(hostAddr - mainMemory) >> PageShift] = FALSE; // in case
+							       // it is code
     switch (size) {
       case 1:
-	mainMemory[physicalAddress] = (unsigned char) (value & 0xff);
+	*hostAddr = (unsigned char) (value & 0xff);
 	break;
 
       case 2:
-	*(unsigned short *) &mainMemory[physicalAddress]
+	*(unsigned short *) hostAddr
 		= ShortToMachine((unsigned short) (value & 0xffff));
 	break;
       
       case 4:
-	*(unsigned int *) &mainMemory[physicalAddress]
+	*(unsigned int *) hostAddr
 		= WordToMachine((unsigned int) value);
 	break;
 	
@@ -166,6 +184,31 @@ Machine::WriteMem(int addr, int size, int value)
     return TRUE;
 }
 
+//----------------------------------------------------------------------
+// Machine::CacheTranslation
+//	Translate has just translated "virtAddr" to "physAddr", and set
+//	the use bit of its page (and the dirty bit, if "writing"), so
+//	further references to the page can skip Translate -- until the
+//	kernel changes the translation, or clears a bit, and calls
+//	FlushTranslations.
+//
+//	With a TLB, the kernel loads entries without telling us, so we
+//	don't cache then.  Nor do we when tracing memory references,
+//	so that every one is traced.
+//----------------------------------------------------------------------
+
+void
+Machine::CacheTranslation(int virtAddr, int physAddr, bool writing)
+{
+    if (tlb != NULL || debug->IsEnabled(dbgAddr)) {
+	return;
+    }
+    readCache.Enter(virtAddr, &mainMemory[physAddr]);
+    if (writing) {
+	writeCache.Enter(virtAddr, &mainMemory[physAddr]);
+    }
+}
+
 //----------------------------------------------------------------------
 // Machine::Translate
 // 	Translate a virtual address into a physical address, using 
@@ -202,8 +245,8 @@ Machine::Translate(int virtAddr, int* physAddr, int size, bool writing)
 
 // calculate the virtual page number, and offset within the page,
 // from the virtual address
-    vpn = (unsigned) virtAddr / PageSize;
-    offset = (unsigned) virtAddr % PageSize;
+    vpn = (unsigned) virtAddr >> PageShift;
+    offset = (unsigned) virtAddr & PageMask;
     
     if (tlb == NULL) {		// => page table => vpn is index into table
 	if (vpn >= pageTableSize) {
@@ -236,14 +279,14 @@ Machine::Translate(int virtAddr, int* physAddr, int size, bool writing)
 
     // if the pageFrame is too big, there is something really wrong! 
     // An invalid translation was loaded into the page table or TLB. 
-    if (pageFrame >= NumPhysPages) { 
+    if (pageFrame >= (unsigned) NumPhysPages) { 
 	DEBUG(dbgAddr, "Illegal pageframe " << pageFrame);
 	return BusErrorException;
     }
     entry->use = TRUE;		// set the use, dirty bits
     if (writing)
 	entry->dirty = TRUE;
-    *physAddr = pageFrame * PageSize + offset;
+    *physAddr = (pageFrame << PageShift) + offset;
     ASSERT((*physAddr >= 0) && ((*physAddr + size) <= MemorySize));
     DEBUG(dbgAddr, "phys addr = " << *physAddr);
     return NoException;
@@ -11,6 +11,7 @@
 #include "copyright.h"
 #include "alarm.h"
 #include "main.h"
+#include "pager.h"
 
 //----------------------------------------------------------------------
 // Alarm::Alarm
@@ -39,8 +40,10 @@ Alarm::Alarm(bool doRandom)
 //	if the interrupted thread called Yield at the point it is 
 //	was interrupted.
 //
-//	For now, just provide time-slicing.  Only need to time slice 
-//      if we're currently running something (in other words, not idle).
+//	For now, just provide time-slicing.  Whether the running thread
+//	should give up the CPU is up to the scheduling policy.  With
+//	demand paging, the page replacement policy gets to sample use
+//	bits as well.
 //----------------------------------------------------------------------
 
 void 
@@ -49,9 +52,11 @@ Alarm::CallBack()
     Interrupt *interrupt = kernel->interrupt;
     MachineStatus status = interrupt->getStatus();                                                                                                                                                                                 
     //mp3
-    kernel->scheduler->Aging();
-    if(kernel->currentThread->getPreempt()) interrupt->YieldOnReturn();
-    if (status != IdleMode && kernel->currentThread->getPriority()<=49) {
+    kernel->scheduler->Tick();
+    if (kernel->pager != NULL) {
+	kernel->pager->Tick();
+    }
+    if (kernel->scheduler->CheckPreempt(status == IdleMode)) {
 	interrupt->YieldOnReturn();
     }
     
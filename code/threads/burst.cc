@@ -0,0 +1,277 @@
+// burst.cc
+//	Routines to predict the CPU bursts of threads, and to report
+//	how good the predictions were.
+//
+// 	These routines assume that interrupts are already disabled.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "debug.h"
+#include "burst.h"
+#include "spec.h"
+#include "main.h"
+
+//----------------------------------------------------------------------
+// CopyName
+//	Return a copy of "name", so it outlives the thread.
+//----------------------------------------------------------------------
+
+static char *
+CopyName(char *name)
+{
+    char *copy = new char[strlen(name) + 1];
+
+    strcpy(copy, name);
+    return copy;
+}
+
+//----------------------------------------------------------------------
+// BurstHistory::BurstHistory
+//	Initialize the history of "thread", before its first burst.
+//----------------------------------------------------------------------
+
+BurstHistory::BurstHistory(Thread *thread)
+{
+    id = thread->getID();
+    name = CopyName(thread->getName());
+    absError = 0;
+    bursts = 0;
+    numBursts = 0;
+}
+
+BurstHistory::~BurstHistory()
+{
+    delete [] name;
+}
+
+//----------------------------------------------------------------------
+// BurstHistory::Add
+//	Remember a burst of "burst" ticks, forgetting the oldest if the
+//	window is full.
+//----------------------------------------------------------------------
+
+void
+BurstHistory::Add(double burst)
+{
+    window[numBursts % BurstWindow] = burst;
+    numBursts++;
+    bursts += burst;
+}
+
+//----------------------------------------------------------------------
+// BurstHistory::Recent
+//	Return the i'th most recent burst; 0 is the one that just ended.
+//----------------------------------------------------------------------
+
+double
+BurstHistory::Recent(int i)
+{
+    ASSERT(i >= 0 && i < numBursts && i < BurstWindow);
+    return window[(numBursts - 1 - i) % BurstWindow];
+}
+
+//----------------------------------------------------------------------
+// BurstEstimator::BurstEstimator
+//	Initialize an estimator, with no threads seen yet.
+//
+//	"description" says which estimator it is, for the report
+//----------------------------------------------------------------------
+
+BurstEstimator::BurstEstimator(char *description)
+{
+    this->description = CopyName(description);
+    histories = new List<BurstHistory *>;
+}
+
+BurstEstimator::~BurstEstimator()
+{
+    while (!histories->IsEmpty()) {
+	delete histories->RemoveFront();
+    }
+    delete histories;
+    delete [] description;
+}
+
+//----------------------------------------------------------------------
+// BurstEstimator::Update
+//	"thread" has gone to sleep after running for "burst" ticks.
+//	Note how far off its last prediction was, and return the next.
+//----------------------------------------------------------------------
+
+double
+BurstEstimator::Update(Thread *thread, double burst)
+{
+    BurstHistory *history = thread->burstHistory;
+    double error = thread->getBurstTime() - burst;
+
+    if (history == NULL) {
+	history = new BurstHistory(thread);
+	thread->burstHistory = history;
+	histories->Append(history);
+    }
+    history->absError += error < 0 ? -error : error;
+    history->Add(burst);
+    return Estimate(thread, history);
+}
+
+//----------------------------------------------------------------------
+// BurstEstimator::Report
+//	Print, for each thread whose bursts were predicted, how long
+//	they were on average and how far off the predictions were;
+//	then the same over all threads.
+//----------------------------------------------------------------------
+
+void
+BurstEstimator::Report()
+{
+    ListIterator<BurstHistory *> iter(histories);
+    double absError = 0;
+    int numBursts = 0;
+
+    if (histories->IsEmpty()) {
+	return;
+    }
+    cout << "Burst prediction (" << description << "):\n";
+    for (; !iter.IsDone(); iter.Next()) {
+	BurstHistory *history = iter.Item();
+	int n = history->NumBursts();
+
+	cout << "Thread " << history->id << " (" << history->name << "): "
+	     << n << " bursts, mean " << history->bursts / n
+	     << ", mean error " << history->absError / n << "\n";
+	absError += history->absError;
+	numBursts += n;
+    }
+    cout << "Burst prediction: mean error " << absError / numBursts
+	 << " over " << numBursts << " bursts\n";
+}
+
+//----------------------------------------------------------------------
+// ExpAverageEstimator
+//	The next burst is alpha times the last one, plus 1-alpha times
+//	the last prediction.
+//----------------------------------------------------------------------
+
+ExpAverageEstimator::ExpAverageEstimator(double alpha)
+	: BurstEstimator("exponential average")
+{
+    ASSERT(alpha >= 0 && alpha <= 1);
+    this->alpha = alpha;
+}
+
+double
+ExpAverageEstimator::Estimate(Thread *thread, BurstHistory *history)
+{
+    return alpha * history->Recent(0) + (1 - alpha) * thread->getBurstTime();
+}
+
+//----------------------------------------------------------------------
+// WindowMeanEstimator
+//	The next burst is the mean of the last k.
+//----------------------------------------------------------------------
+
+WindowMeanEstimator::WindowMeanEstimator(int k)
+	: BurstEstimator("window mean")
+{
+    ASSERT(k > 0 && k <= BurstWindow);
+    this->k = k;
+}
+
+double
+WindowMeanEstimator::Estimate(Thread *thread, BurstHistory *history)
+{
+    int n = min(k, history->NumBursts());
+    double sum = 0;
+
+    for (int i = 0; i < n; i++) {
+	sum += history->Recent(i);
+    }
+    return sum / n;
+}
+
+//----------------------------------------------------------------------
+// MedianEstimator
+//	The next burst is the median of the last k, so one unusually
+//	long or short burst does not throw the prediction off.
+//----------------------------------------------------------------------
+
+MedianEstimator::MedianEstimator(int k)
+	: BurstEstimator("window median")
+{
+    ASSERT(k > 0 && k <= BurstWindow);
+    this->k = k;
+}
+
+double
+MedianEstimator::Estimate(Thread *thread, BurstHistory *history)
+{
+    int n = min(k, history->NumBursts());
+    double sorted[BurstWindow];
+
+    for (int i = 0; i < n; i++) {	// insertion sort; n is small
+	double burst = history->Recent(i);
+	int j;
+
+	for (j = i; j > 0 && sorted[j - 1] > burst; j--) {
+	    sorted[j] = sorted[j - 1];
+	}
+	sorted[j] = burst;
+    }
+    if (n % 2 == 1) {
+	return sorted[n / 2];
+    }
+    return (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+}
+
+//----------------------------------------------------------------------
+// ProgramHistoryEstimator::ProgramHistoryEstimator
+//	Initialize an estimator that predicts from the mean burst of
+//	each program, which the profile keeps (see profile.h).
+//----------------------------------------------------------------------
+
+ProgramHistoryEstimator::ProgramHistoryEstimator()
+	: BurstEstimator("program history")
+{
+}
+
+//----------------------------------------------------------------------
+// ProgramHistoryEstimator::Estimate
+//	Fold the burst into the mean for the thread's program; that is
+//	the prediction.
+//----------------------------------------------------------------------
+
+double
+ProgramHistoryEstimator::Estimate(Thread *thread, BurstHistory *history)
+{
+    return kernel->burstProfile->AddBurst(thread->getName(),
+							history->Recent(0));
+}
+
+//----------------------------------------------------------------------
+// NewBurstEstimator
+//	Make the estimator described by "spec": a name, optionally
+//	followed by ':' and a parameter (see spec.h).  Return NULL if
+//	there is no estimator by that name, or the parameter is bad.
+//----------------------------------------------------------------------
+
+BurstEstimator *
+NewBurstEstimator(char *spec)
+{
+    Spec s(spec);
+    double alpha;
+    int k;
+
+    if (s.Is("exp") && s.DoubleParam(&alpha, 0.5, 0, 1)) {
+	return new ExpAverageEstimator(alpha);
+    } else if (s.Is("mean") && s.IntParam(&k, 4, 1, BurstWindow)) {
+	return new WindowMeanEstimator(k);
+    } else if (s.Is("median") && s.IntParam(&k, 5, 1, BurstWindow)) {
+	return new MedianEstimator(k);
+    } else if (s.Is("history") && s.Param() == NULL) {
+	return new ProgramHistoryEstimator();
+    }
+    return NULL;
+}
@@ -0,0 +1,130 @@
+// burst.h
+//	Data structures for predicting the CPU bursts of threads.
+//
+//	Shortest-remaining-time-first scheduling (L1 of the three-level
+//	policy) needs to know how long a thread will run before it
+//	next goes to sleep.  We guess from how long it ran before.
+//	When a burst ends, the BurstEstimator is told how long it was,
+//	and makes a new prediction.  Several ways of guessing are
+//	provided; "-burst <name>[:<parameter>]" picks one:
+//
+//	   exp[:alpha]	   exponential average, alpha of the new burst
+//			   and 1-alpha of the old prediction (default
+//			   0.5, as Nachos always did)
+//	   mean[:k]	   mean of the last k bursts (default 4)
+//	   median[:k]	   median of the last k bursts (default 5)
+//	   history	   mean of every burst of the same program,
+//			   in this run and, with "-profile", earlier
+//			   ones (see profile.h)
+//
+//	The estimator keeps a BurstHistory for each thread -- its last
+//	few bursts, and how far off the predictions were -- and at
+//	halt prints the prediction error for each thread.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef BURST_H
+#define BURST_H
+
+#include "copyright.h"
+#include "list.h"
+#include "thread.h"
+
+const int BurstWindow = 16;		// bursts of each thread we remember
+
+// What we remember about one thread's bursts.  Owned by the
+// estimator, so it is still there for the report once the thread
+// has gone.
+
+class BurstHistory {
+  public:
+    BurstHistory(Thread *thread);	// no bursts yet
+    ~BurstHistory();
+
+    void Add(double burst);	// remember a burst that just ended
+    int NumBursts() { return numBursts; }
+    double Recent(int i);	// the i'th most recent burst, 0 first
+
+    int id;			// the thread's ID
+    char *name;			// a copy of its name
+    double absError;		// sum of |prediction - burst|
+    double bursts;		// sum of its bursts
+
+  private:
+    double window[BurstWindow];	// the last bursts, as a ring
+    int numBursts;		// bursts in all
+};
+
+// The interface for all the estimators.  Update does the common
+// bookkeeping, and asks Estimate for the new prediction.
+
+class BurstEstimator {
+  public:
+    BurstEstimator(char *description);
+    virtual ~BurstEstimator();
+
+    double Update(Thread *thread, double burst);
+				// "thread"'s CPU burst just ended, after
+				// "burst" ticks; return its next burst
+    void Report();		// print the prediction error per thread
+
+  protected:
+    virtual double Estimate(Thread *thread, BurstHistory *history) = 0;
+				// predict the next burst, given the ones
+				// so far (the latest is in "history")
+
+  private:
+    char *description;		// which estimator this is, for the report
+    List<BurstHistory *> *histories;	// one per thread seen
+};
+
+class ExpAverageEstimator : public BurstEstimator {
+  public:
+    ExpAverageEstimator(double alpha);
+
+  protected:
+    double Estimate(Thread *thread, BurstHistory *history);
+
+  private:
+    double alpha;		// weight of the latest burst
+};
+
+class WindowMeanEstimator : public BurstEstimator {
+  public:
+    WindowMeanEstimator(int k);
+
+  protected:
+    double Estimate(Thread *thread, BurstHistory *history);
+
+  private:
+    int k;			// how many bursts to average
+};
+
+class MedianEstimator : public BurstEstimator {
+  public:
+    MedianEstimator(int k);
+
+  protected:
+    double Estimate(Thread *thread, BurstHistory *history);
+
+  private:
+    int k;			// how many bursts to take the median of
+};
+
+// The mean burst of each program is kept in its profile.
+
+class ProgramHistoryEstimator : public BurstEstimator {
+  public:
+    ProgramHistoryEstimator();
+
+  protected:
+    double Estimate(Thread *thread, BurstHistory *history);
+};
+
+// Make the estimator described by "spec" ("exp:0.3", "median", ...);
+// NULL if there is no such estimator.
+extern BurstEstimator *NewBurstEstimator(char *spec);
+
+#endif // BURST_H
@@ -0,0 +1,295 @@
+// cfs.cc
+//	Routines for the "completely fair" scheduling policy: ready
+//	threads in a red-black tree by weighted virtual run time,
+//	leftmost first.
+//
+// 	These routines assume that interrupts are already disabled.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "debug.h"
+#include "cfs.h"
+#include "main.h"
+
+// The weight for each of 40 steps of priority, highest first; the
+// same as the Linux table for nice -20 to 19.  Each step is ~1.25x
+// the next, so one step of priority is worth about 10% more CPU.
+static const int cfsWeight[40] = {
+    88761, 71755, 56483, 46273, 36291,
+    29154, 23254, 18705, 14949, 11916,
+     9548,  7620,  6100,  4904,  3906,
+     3121,  2501,  1991,  1586,  1277,
+     1024,   820,   655,   526,   423,
+      335,   272,   215,   172,   137,
+      110,    87,    70,    56,    45,
+       36,    29,    23,    18,    15,
+};
+
+//----------------------------------------------------------------------
+// Weight
+//	Return the weight of "thread": its priority (0..149) is spread
+//	over the 40 steps of the weight table.
+//----------------------------------------------------------------------
+
+static int
+Weight(Thread *thread)
+{
+    int priority = thread->getPriority();
+
+    if (priority < 0) {
+	priority = 0;
+    } else if (priority >= NumPriorities) {
+	priority = NumPriorities - 1;
+    }
+    return cfsWeight[39 - priority * 40 / NumPriorities];
+}
+
+//----------------------------------------------------------------------
+// VruntimeCompare
+//	Order threads by virtual run time, least first.
+//----------------------------------------------------------------------
+
+static int
+VruntimeCompare(Thread *x, Thread *y)
+{
+    if (x->vruntime == y->vruntime) {
+	return 0;
+    }
+    return x->vruntime > y->vruntime ? 1 : -1;
+}
+
+//----------------------------------------------------------------------
+// CFSPolicy::CFSPolicy
+//	Initialize the policy, with no ready threads.
+//----------------------------------------------------------------------
+
+CFSPolicy::CFSPolicy()
+{
+    timeline = new RBTree<Thread *>(VruntimeCompare);
+    minVruntime = 0;
+    totalWeight = 0;
+    accounts = NULL;
+    numAccounts = 0;
+}
+
+//----------------------------------------------------------------------
+// CFSPolicy::~CFSPolicy
+//	De-allocate the tree.  Does not delete the threads on it.
+//----------------------------------------------------------------------
+
+CFSPolicy::~CFSPolicy()
+{
+    delete timeline;
+    delete [] accounts;
+}
+
+//----------------------------------------------------------------------
+// CFSPolicy::AccountOf
+//	Return the account for "thread", making room for it if this is
+//	the first we have seen of it.
+//----------------------------------------------------------------------
+
+CFSAccount *
+CFSPolicy::AccountOf(Thread *thread)
+{
+    int id;
+    CFSAccount *account;
+
+    kernel->threadStats->Of(thread);	// make sure it has a slot
+    id = thread->statsIndex;
+    if (id >= numAccounts) {		// grow the table
+	int size = 2 * id + 8;
+	CFSAccount *bigger = new CFSAccount[size];
+
+	for (int i = 0; i < size; i++) {
+	    if (i < numAccounts) {
+		bigger[i] = accounts[i];
+	    } else {
+		bigger[i].name = NULL;
+	    }
+	}
+	delete [] accounts;
+	accounts = bigger;
+	numAccounts = size;
+    }
+    account = &accounts[id];
+    if (account->name == NULL) {
+	account->name = thread->getName();
+	account->id = thread->getID();
+	account->cpuTicks = 0;
+	account->waitTicks = 0;
+    }
+    account->weight = Weight(thread);
+    return account;
+}
+
+//----------------------------------------------------------------------
+// CFSPolicy::Charge
+//	Add the time "thread" has run since it was dispatched to its
+//	virtual run time, scaled by its weight.  Called as it gives up
+//	the CPU.
+//----------------------------------------------------------------------
+
+void
+CFSPolicy::Charge(Thread *thread)
+{
+    CFSAccount *account = AccountOf(thread);
+    int ran = RunTime(thread);
+
+    thread->vruntime += (double) ran * CFSNiceZeroWeight / Weight(thread);
+    account->cpuTicks += ran;
+    account->vruntime = thread->vruntime;
+}
+
+//----------------------------------------------------------------------
+// CFSPolicy::Slice
+//	Return the fair slice of the running thread: its share, by
+//	weight, of CFSLatency, among itself and the ready threads.
+//----------------------------------------------------------------------
+
+int
+CFSPolicy::Slice(Thread *current)
+{
+    int weight = Weight(current);
+    int slice = (int) ((double) CFSLatency * weight / (totalWeight + weight));
+
+    return slice < CFSMinGranularity ? CFSMinGranularity : slice;
+}
+
+//----------------------------------------------------------------------
+// CFSPolicy::Enqueue
+//	Put a ready thread in the tree.  The running thread, yielding,
+//	is charged for its run first; any other thread is brought up
+//	to at least minVruntime, and preempts the running thread if it
+//	is far enough behind it.  A thread's vruntime must not change
+//	while it is in the tree.
+//----------------------------------------------------------------------
+
+void
+CFSPolicy::Enqueue(Thread *thread)
+{
+    Thread *current = kernel->currentThread;
+
+    if (thread == current) {			// yielding
+	Charge(thread);
+    } else {
+	if (thread->vruntime < minVruntime) {
+	    thread->vruntime = minVruntime;
+	}
+	if (CanPreempt(current, thread)) {
+	    double ran = (double) RunTime(current) * CFSNiceZeroWeight
+						/ Weight(current);
+	    if (current->vruntime + ran - thread->vruntime
+						> CFSMinGranularity) {
+		current->setPreempt(TRUE);
+	    }
+	}
+    }
+    AccountOf(thread);
+    Inserted(thread, "CFS");
+    timeline->Insert(thread);
+    totalWeight += Weight(thread);
+}
+
+//----------------------------------------------------------------------
+// CFSPolicy::Dequeue
+//	Take the leftmost thread -- the one furthest behind -- out of
+//	the tree, and return it; NULL if the tree is empty.
+//----------------------------------------------------------------------
+
+Thread *
+CFSPolicy::Dequeue()
+{
+    Thread *next;
+
+    if (timeline->IsEmpty()) {
+	return NULL;
+    }
+    next = timeline->RemoveFront();
+    totalWeight -= Weight(next);
+    minVruntime = next->vruntime;
+    AccountOf(next)->waitTicks += kernel->stats->totalTicks - next->getReady();
+    Removed(next, "CFS");
+    return next;
+}
+
+//----------------------------------------------------------------------
+// CFSPolicy::CheckPreempt
+//	The running thread yields if a thread that woke up preempted
+//	it, or if it has run for its fair slice and someone is waiting.
+//----------------------------------------------------------------------
+
+bool
+CFSPolicy::CheckPreempt(Thread *current, bool idle)
+{
+    if (current->getPreempt()) {
+	return TRUE;
+    }
+    if (idle || timeline->IsEmpty()) {
+	return FALSE;
+    }
+    return RunTime(current) >= Slice(current);
+}
+
+//----------------------------------------------------------------------
+// CFSPolicy::UpdateBurst
+//	The running thread is going to sleep; charge it for its run.
+//----------------------------------------------------------------------
+
+void
+CFSPolicy::UpdateBurst(Thread *thread)
+{
+    Charge(thread);
+}
+
+//----------------------------------------------------------------------
+// CFSPolicy::Report
+//	Print, for each thread, its weight, the CPU and wait time it
+//	had, and its CPU time scaled by its weight (its "service");
+//	then Jain's fairness index of the service the threads other
+//	than main got: 1 if they all got the same, 1/n at worst.
+//----------------------------------------------------------------------
+
+void
+CFSPolicy::Report()
+{
+    double sum = 0, sumSquares = 0;
+    double minV = 0, maxV = 0;
+    int n = 0;
+
+    cout << "CFS fairness:\n";
+    for (int i = 0; i < numAccounts; i++) {
+	CFSAccount *account = &accounts[i];
+	double service;
+
+	if (account->name == NULL) {
+	    continue;
+	}
+	service = (double) account->cpuTicks * CFSNiceZeroWeight
+						/ account->weight;
+	cout << "Thread " << account->id << " (" << account->name << "): weight "
+	     << account->weight << ", cpu " << account->cpuTicks
+	     << ", wait " << account->waitTicks << ", service "
+	     << service << "\n";
+	if (i == 0) {			// main, just starts the others;
+					// it always has the first slot
+	    continue;
+	}
+	if (n == 0 || account->vruntime < minV) {
+	    minV = account->vruntime;
+	}
+	if (n == 0 || account->vruntime > maxV) {
+	    maxV = account->vruntime;
+	}
+	sum += service;
+	sumSquares += service * service;
+	n++;
+    }
+    if (n > 0 && sumSquares > 0) {
+	cout << "CFS fairness: Jain index " << sum * sum / (n * sumSquares)
+	     << ", vruntime spread " << maxV - minV << "\n";
+    }
+}
@@ -0,0 +1,80 @@
+// cfs.h
+//	Data structures for a "completely fair" scheduling policy, in
+//	the style of the Linux CFS scheduler.
+//
+//	Every thread has a weight, from its priority (through a table
+//	like the Linux nice-to-weight table: each step of priority is
+//	worth about 10% more CPU), and a virtual run time
+//	(Thread::vruntime): the CPU time it has had, scaled down by its
+//	weight.  Ready threads are kept in a red-black tree by virtual
+//	run time, and the leftmost -- the one furthest behind its fair
+//	share -- runs next.
+//
+//	The running thread gives way, at a timer interrupt, once it has
+//	run for its fair slice: its share, by weight, of CFSLatency, but
+//	no less than CFSMinGranularity.  A thread that wakes up more
+//	than CFSMinGranularity behind the running thread preempts it.
+//	A thread that has been away (asleep, or new) comes back no
+//	further behind than the thread that last ran, so it cannot
+//	monopolize the CPU to catch up.
+//
+//	At halt, we print how much CPU each thread got against its
+//	weight, and how fairly, overall, the CPU was shared.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef CFS_H
+#define CFS_H
+
+#include "copyright.h"
+#include "rbtree.h"
+#include "schedpolicy.h"
+
+const int CFSLatency = 600;		// ticks in which every ready thread
+					// should get to run once
+const int CFSMinGranularity = 100;	// shortest slice we hand out
+const int CFSNiceZeroWeight = 1024;	// weight whose vruntime runs at
+					// the speed of real time
+
+// What the policy remembers about each thread, for the report at
+// halt -- the thread itself is gone by then.
+
+class CFSAccount {
+  public:
+    char *name;			// the thread's name, NULL if no thread
+    int id;			// the thread's ID
+    int weight;			// its weight
+    int cpuTicks;		// CPU time it has had
+    int waitTicks;		// time it has spent in the tree
+    double vruntime;		// its virtual run time, when it last ran
+};
+
+class CFSPolicy : public SchedulingPolicy {
+  public:
+    CFSPolicy();		// initialize an empty tree
+    ~CFSPolicy();
+
+    void Enqueue(Thread *thread);
+    Thread *Dequeue();
+    bool CheckPreempt(Thread *current, bool idle);
+    void UpdateBurst(Thread *thread);
+    void Report();		// print the fairness of the run
+
+  private:
+    RBTree<Thread *> *timeline;	// ready threads, by vruntime
+    double minVruntime;		// vruntime of the last thread dispatched
+    int totalWeight;		// weight of the threads in the tree
+    CFSAccount *accounts;	// per thread, indexed by the thread's
+				// slot in kernel->threadStats; IDs
+				// are reused, slots are not
+    int numAccounts;		// number of slots in accounts
+
+    int Slice(Thread *current);	// fair slice for the running thread
+    void Charge(Thread *thread);// add the ticks "thread" just ran
+    CFSAccount *AccountOf(Thread *thread);
+				// the account for "thread"
+};
+
+#endif // CFS_H
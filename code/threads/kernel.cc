@@ -15,6 +15,9 @@
 #include "libtest.h"
 #include "string.h"
 #include "synchdisk.h"
+#include "pager.h"
+#include "frametable.h"
+#include "sharedcode.h"
 #include "post.h"
 #include "synchconsole.h"
 
@@ -27,7 +30,21 @@
 Kernel::Kernel(int argc, char **argv)
 {
     randomSlice = FALSE; 
+    readyQueueType = ThreeQueues;
+    schedPolicyName = "multilevel";
+    threadStatsFile = NULL;    // default is not to write them
+    schedTraceFile = NULL;     // default is not to save them
+    burstEstimatorSpec = "exp";   // default is the old 0.5 average
+    burstProfileFile = NULL;   // default is to start every program cold
+    replayMode = ReplayOff;    // default is neither record nor replay
+    replayFile = NULL;
+    demandPaging = FALSE;      // default is to load programs whole
+    replacementSpec = "fifo";  // default is the oldest page out first
+    workload = new Workload();	// default is no user programs
     debugUserProg = FALSE;
+    pageSize = DefaultPageSize;        // default memory is as it always was
+    numPhysPages = DefaultNumPhysPages;
+    tlbSize = DefaultTLBSize;
     consoleIn = NULL;          // default is stdin
     consoleOut = NULL;         // default is stdout
 #ifndef FILESYS_STUB
@@ -36,8 +53,6 @@ Kernel::Kernel(int argc, char **argv)
     reliability = 1;            // network reliability, default is 1.0
     hostName = 0;               // machine id, also UNIX socket name
                                 // 0 is the default machine id
-usedPhyPage[NumPhysPages] = {0};
-countPhyPage = NumPhysPages;
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "-rs") == 0) {
  	    	ASSERT(i + 1 < argc);
@@ -47,13 +62,90 @@ countPhyPage = NumPhysPages;
 	    	i++;
         } else if (strcmp(argv[i], "-s") == 0) {
             debugUserProg = TRUE;
+        } else if (strcmp(argv[i], "-sched") == 0) {
+	    	ASSERT(i + 1 < argc);
+	    	schedPolicyName = argv[i + 1];
+	    	i++;
+        } else if (strcmp(argv[i], "-rq") == 0) {
+	    	ASSERT(i + 1 < argc);
+	    	if (strcmp(argv[i + 1], "levels") == 0) {
+	    	    readyQueueType = PriorityLevels;
+	    	} else if (strcmp(argv[i + 1], "bands") == 0) {
+	    	    readyQueueType = PriorityBands;
+	    	} else {
+	    	    ASSERT(strcmp(argv[i + 1], "three") == 0);
+	    	    readyQueueType = ThreeQueues;
+	    	}
+	    	i++;
+        } else if (strcmp(argv[i], "-stats") == 0) {
+	    	ASSERT(i + 1 < argc);
+	    	threadStatsFile = argv[i + 1];
+	    	i++;
+        } else if (strcmp(argv[i], "-trace") == 0) {
+	    	ASSERT(i + 1 < argc);
+	    	schedTraceFile = argv[i + 1];
+	    	i++;
+        } else if (strcmp(argv[i], "-burst") == 0) {
+	    	ASSERT(i + 1 < argc);
+	    	burstEstimatorSpec = argv[i + 1];
+	    	i++;
+        } else if (strcmp(argv[i], "-profile") == 0) {
+	    	ASSERT(i + 1 < argc);
+	    	burstProfileFile = argv[i + 1];
+	    	i++;
+        } else if (strcmp(argv[i], "-vm") == 0) {
+	    	demandPaging = TRUE;
+        } else if (strcmp(argv[i], "-replace") == 0) {
+	    	ASSERT(i + 1 < argc);
+	    	replacementSpec = argv[i + 1];
+	    	i++;
+        } else if (strcmp(argv[i], "-pagesize") == 0) {
+	    	ASSERT(i + 1 < argc);
+	    	pageSize = atoi(argv[i + 1]);
+	    	i++;
+        } else if (strcmp(argv[i], "-physpages") == 0) {
+	    	ASSERT(i + 1 < argc);
+	    	numPhysPages = atoi(argv[i + 1]);
+	    	i++;
+        } else if (strcmp(argv[i], "-tlbsize") == 0) {
+	    	ASSERT(i + 1 < argc);
+	    	tlbSize = atoi(argv[i + 1]);
+	    	i++;
+        } else if (strcmp(argv[i], "-record") == 0) {
+	    	ASSERT(i + 1 < argc);
+	    	replayMode = ReplayRecording;
+	    	replayFile = argv[i + 1];
+	    	i++;
+        } else if (strcmp(argv[i], "-replay") == 0) {
+	    	ASSERT(i + 1 < argc);
+	    	replayMode = ReplayPlayback;
+	    	replayFile = argv[i + 1];
+	    	i++;
 		} else if (strcmp(argv[i], "-e") == 0) {
-        	execfile[++execfileNum]= argv[++i];
-			cout << execfile[execfileNum] << "\n";
+	    	ASSERT(i + 1 < argc);
+	    	workload->Add(argv[i + 1], 0, 0);
+			cout << argv[i + 1] << "\n";
+	    	i++;
 		} else if (strcmp(argv[i], "-ep") ==0) {
-		execfile[++execfileNum]= argv[++i];
-                priority[++priorityNum] = atoi(argv[++i]);
-			cout << execfile[execfileNum] << "\n"; 
+	    	ASSERT(i + 2 < argc);
+	    	workload->Add(argv[i + 1], atoi(argv[i + 2]), 0);
+			cout << argv[i + 1] << "\n";
+	    	i += 2;
+		} else if (strcmp(argv[i], "-jobs") == 0) {
+	    	ASSERT(i + 1 < argc);
+	    	if (!workload->ReadJobFile(argv[i + 1])) {
+	    	    cout << "Can't read job file: " << argv[i + 1] << "\n";
+	    	    ASSERT(FALSE);
+	    	}
+	    	i++;
+		} else if (strcmp(argv[i], "-gen") == 0) {
+	    	ASSERT(i + 3 < argc);
+	    	if (!workload->Generate(argv[i + 1], argv[i + 2],
+						atoi(argv[i + 3]))) {
+	    	    cout << "Unknown arrival generator: " << argv[i + 1] << "\n";
+	    	    ASSERT(FALSE);
+	    	}
+	    	i += 3;
 		} else if (strcmp(argv[i], "-ci") == 0) {
 	    	ASSERT(i + 1 < argc);
 	    	consoleIn = argv[i + 1];
@@ -77,6 +169,17 @@ countPhyPage = NumPhysPages;
         } else if (strcmp(argv[i], "-u") == 0) {
             cout << "Partial usage: nachos [-rs randomSeed]\n";
 	   		cout << "Partial usage: nachos [-s]\n";
+            cout << "Partial usage: nachos [-sched multilevel|rr|priority|mlfq|cfs|lottery|stride]\n";
+            cout << "Partial usage: nachos [-rq three|levels|bands]\n";
+            cout << "Partial usage: nachos [-stats file.json|file.csv|-]\n";
+            cout << "Partial usage: nachos [-trace traceFile]\n";
+            cout << "Partial usage: nachos [-burst exp[:alpha]|mean[:k]|median[:k]|history]\n";
+            cout << "Partial usage: nachos [-profile profileFile]\n";
+            cout << "Partial usage: nachos [-vm] [-replace fifo|clock|lru[:bits]|wsclock[:tau]]\n";
+            cout << "Partial usage: nachos [-pagesize bytes] [-physpages #] [-tlbsize #]\n";
+            cout << "Partial usage: nachos [-record logFile] [-replay logFile]\n";
+            cout << "Partial usage: nachos [-e file] [-ep file priority] [-jobs jobFile]\n";
+            cout << "Partial usage: nachos [-gen poisson|bursty:count:gap[:seed] file priority]\n";
             cout << "Partial usage: nachos [-ci consoleIn] [-co consoleOut]\n";
 #ifndef FILESYS_STUB
 	    	cout << "Partial usage: nachos [-nf]\n";
@@ -96,19 +199,40 @@ countPhyPage = NumPhysPages;
 void
 Kernel::Initialize()
 {
+    SchedulingPolicy *policy;
+
     // We didn't explicitly allocate the current thread we are running in.
     // But if it ever tries to give up the CPU, we better have a Thread
     // object to save its state. 
 
-	
-    currentThread = new Thread("main", threadNum++);		
+    threadTable = new ThreadTable();
+    currentThread = new Thread("main", threadTable->Allocate());
+    threadTable->Register(currentThread);
     currentThread->setStatus(RUNNING);
 
     stats = new Statistics();		// collect statistics
+    replay = new ReplayLog(replayMode, replayFile);
+    threadStats = new ThreadStatTable(threadStatsFile, schedPolicyName);
+    threadStats->Of(currentThread);	// main arrives, and runs, at once
+    threadStats->Dispatched(currentThread);
+    schedTrace = new SchedTrace(schedTraceFile);	// trace scheduling
+    burstEstimator = NewBurstEstimator(burstEstimatorSpec);
+    if (burstEstimator == NULL) {
+	cout << "Unknown burst estimator: " << burstEstimatorSpec << "\n";
+	ASSERT(FALSE);
+    }
+    burstProfile = new BurstProfile(burstProfileFile);
     interrupt = new Interrupt;		// start up interrupt handling
-    scheduler = new Scheduler();	// initialize the ready queue
+    policy = NewSchedulingPolicy(schedPolicyName, readyQueueType);
+    if (policy == NULL) {
+	cout << "Unknown scheduling policy: " << schedPolicyName << "\n";
+	ASSERT(FALSE);
+    }
+    scheduler = new Scheduler(policy);	// initialize the ready queue
     alarm = new Alarm(randomSlice);	// start up time slicing
-    machine = new Machine(debugUserProg);
+    machine = new Machine(debugUserProg, pageSize, numPhysPages, tlbSize);
+    frames = new FrameTable(NumPhysPages);	// all of memory is free
+    sharedCode = new SharedCode();	// no programs loaded yet
     synchConsoleIn = new SynchConsoleInput(consoleIn); // input from stdin
     synchConsoleOut = new SynchConsoleOutput(consoleOut); // output to stdout
     synchDisk = new SynchDisk();    //
@@ -117,6 +241,22 @@ Kernel::Initialize()
 #else
     fileSystem = new FileSystem(formatFlag);
 #endif // FILESYS_STUB
+    pager = NULL;
+    if (demandPaging) {
+	ReplacementPolicy *replacement;
+
+#ifndef FILESYS_STUB
+	cout << "Demand paging swaps to the whole disk, so it needs the "
+		"stub file system\n";
+	ASSERT(FALSE);
+#endif
+	replacement = NewReplacementPolicy(replacementSpec);
+	if (replacement == NULL) {
+	    cout << "Unknown replacement policy: " << replacementSpec << "\n";
+	    ASSERT(FALSE);
+	}
+	pager = new Pager(replacement);
+    }
 //    postOfficeIn = new PostOfficeInput(10);
 //    postOfficeOut = new PostOfficeOutput(reliability);
 
@@ -131,14 +271,24 @@ Kernel::Initialize()
 Kernel::~Kernel()
 {
     delete stats;
+    delete threadStats;
     delete interrupt;
     delete scheduler;
+    delete schedTrace;
+    delete burstEstimator;
+    delete burstProfile;
     delete alarm;
     delete machine;
+    delete sharedCode;
+    delete frames;
     delete synchConsoleIn;
     delete synchConsoleOut;
+    delete pager;
     delete synchDisk;
     delete fileSystem;
+    delete replay;
+    delete workload;
+    delete threadTable;
 //    delete postOfficeIn;
 //    delete postOfficeOut;
     
@@ -153,12 +303,17 @@ Kernel::~Kernel()
 void
 Kernel::ThreadSelfTest() {
    Semaphore *semaphore;
+   ReadyQueue *readyQueue;
    SynchList<int> *synchList;
    
    LibSelfTest();		// test library routines
    
    currentThread->SelfTest();	// test thread switching
    
+   readyQueue = new ReadyQueue(3);	// test the multilevel ready queue
+   readyQueue->SelfTest();
+   delete readyQueue;
+   
    				// test semaphore operation
    semaphore = new Semaphore("test", 0);
    semaphore->SelfTest();
@@ -266,9 +421,7 @@ void ForkExecute(Thread *t)
 
 void Kernel::ExecAll()
 {
-	for (int i=1;i<=execfileNum;i++) {
-		int a = Exec(execfile[i],priority[i]);
-	}
+	workload->Launch();
 	currentThread->Finish();
     //Kernel::Exec();	
 }
@@ -276,12 +429,15 @@ void Kernel::ExecAll()
 
 int Kernel::Exec(char* name,int priority)
 {
-	t[threadNum] = new Thread(name, threadNum, priority);
-	t[threadNum]->space = new AddrSpace();
-	t[threadNum]->Fork((VoidFunctionPtr) &ForkExecute, (void *)t[threadNum]);
-	threadNum++;
+	int id = threadTable->Allocate();
+	Thread *t = new Thread(name, id, priority);
+
+	threadTable->Register(t);
+	burstProfile->Seed(t);	// as it ran last time
+	t->space = new AddrSpace();
+	t->Fork((VoidFunctionPtr) &ForkExecute, (void *)t);
 
-	return threadNum-1;
+	return id;
 /*
     cout << "Total threads number is " << execfileNum << endl;
     for (int n=1;n<=execfileNum;n++) {
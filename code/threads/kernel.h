@@ -13,8 +13,15 @@
 #include "utility.h"
 #include "thread.h"
 #include "scheduler.h"
+#include "threadstats.h"
+#include "schedtrace.h"
+#include "burst.h"
+#include "profile.h"
+#include "threadtable.h"
+#include "workload.h"
 #include "interrupt.h"
 #include "stats.h"
+#include "replay.h"
 #include "alarm.h"
 #include "filesys.h"
 #include "machine.h"
@@ -24,6 +31,9 @@ class PostOfficeOutput;
 class SynchConsoleInput;
 class SynchConsoleOutput;
 class SynchDisk;
+class Pager;
+class FrameTable;
+class SharedCode;
 
 typedef int OpenFileId;
 
@@ -42,7 +52,7 @@ class Kernel {
 	
     void ConsoleTest();         // interactive console self test
     void NetworkTest();         // interactive 2-machine network test
-    Thread* getThread(int threadID){return t[threadID];}    
+    Thread* getThread(int threadID){return threadTable->Get(threadID);}
 
 
     void PrintInt(int number); 	
@@ -57,32 +67,49 @@ class Kernel {
 // they're global variables used everywhere.
 
     Thread *currentThread;	// the thread holding the CPU
+    ThreadTable *threadTable;	// every thread, by ID
     Scheduler *scheduler;	// the ready list
     Interrupt *interrupt;	// interrupt status
     Statistics *stats;		// performance metrics
+    ReplayLog *replay;		// nondeterministic inputs, recorded
+				// or replayed
+    ThreadStatTable *threadStats;	// per thread scheduling metrics
+    SchedTrace *schedTrace;	// recent scheduling events
+    BurstEstimator *burstEstimator;	// predicts CPU bursts
+    BurstProfile *burstProfile;	// how programs ran before
     Alarm *alarm;		// the software alarm clock    
     Machine *machine;           // the simulated CPU
     SynchConsoleInput *synchConsoleIn;
     SynchConsoleOutput *synchConsoleOut;
     SynchDisk *synchDisk;
     FileSystem *fileSystem;     
+    Pager *pager;		// brings in pages of user programs as
+				// they are touched; NULL if they are
+				// loaded whole
     PostOfficeInput *postOfficeIn;
     PostOfficeOutput *postOfficeOut;
 
+    FrameTable *frames;		// which physical pages are in use
+    SharedCode *sharedCode;	// pages shared by programs running
+				// the same executable
     int hostName;               // machine identifier
-bool usedPhyPage[NumPhysPages];
-int  countPhyPage;
   private:
-	//mp3
-	int priority[10];
-        int priorityNum;
-
-	Thread* t[10];
-	char*   execfile[10];
-	int execfileNum;
-	int threadNum;
+    Workload *workload;		// user programs to run
     bool randomSlice;		// enable pseudo-random time slicing
+    char *schedPolicyName;	// which scheduling policy to use
+    ReadyQueueType readyQueueType;	// which ready queue it should keep
+    char *threadStatsFile;	// file to write thread statistics to
+    char *schedTraceFile;	// file to save scheduling events to
+    char *burstEstimatorSpec;	// how to predict CPU bursts
+    char *burstProfileFile;	// file to keep program profiles in
+    ReplayMode replayMode;	// record, or replay, the run?
+    char *replayFile;		// the log to record to or replay from
+    bool demandPaging;		// load user programs a page at a time?
+    char *replacementSpec;	// how to pick pages to take out
     bool debugUserProg;         // single step user program
+    int pageSize;		// bytes in a page of user memory
+    int numPhysPages;		// pages of physical memory
+    int tlbSize;		// entries in the TLB
     double reliability;         // likelihood messages are dropped
     char *consoleIn;            // file to read console input from
     char *consoleOut;           // file to send console output to
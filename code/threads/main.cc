@@ -13,6 +13,26 @@
 //    -rs causes Yield to occur at random (but repeatable) spots
 //    -z prints the copyright message
 //    -s causes user programs to be executed in single-step mode
+//    -sched picks the scheduling policy (see schedpolicy.h)
+//    -rq picks the ready queue the multilevel policy keeps
+//    -stats writes per thread scheduling statistics at halt (see
+//        threadstats.h)
+//    -trace saves every scheduling event to a file (see schedtrace.h)
+//    -burst picks how CPU bursts are predicted (see burst.h)
+//    -profile keeps what was learned about each program across runs
+//        (see profile.h)
+//    -vm loads user programs a page at a time, as they touch them,
+//        paging out to the disk when memory runs out (see pager.h);
+//        -replace picks which page goes out (see replace.h)
+//    -pagesize, -physpages and -tlbsize size the simulated memory
+//        (see machine.h)
+//    -record logs every nondeterministic input, and scheduling
+//        decision, to a file; -replay reruns from it (see replay.h)
+//    -e runs a user program, -ep at a given priority; -jobs runs
+//        every program listed in a job file, each when it arrives;
+//        -gen runs a program many times, arriving at random
+//        (see workload.h)
+//    -tracedump prints a file saved with -trace, and exits
 //    -x runs a user program
 //    -ci specify file for console input (stdin is the default)
 //    -co specify file for console output (stdout is the default)
@@ -172,6 +192,7 @@ main(int argc, char **argv)
     bool threadTestFlag = false;
     bool consoleTestFlag = false;
     bool networkTestFlag = false;
+    char *traceDumpName = NULL;	      // trace file to print
 #ifndef FILESYS_STUB
     char *copyUnixFileName = NULL;    // UNIX file to be copied into Nachos
     char *copyNachosFileName = NULL;  // name of copied file in Nachos
@@ -207,6 +228,11 @@ main(int argc, char **argv)
 	else if (strcmp(argv[i], "-N") == 0) {
 	    networkTestFlag = TRUE;
 	}
+	else if (strcmp(argv[i], "-tracedump") == 0) {
+	    ASSERT(i + 1 < argc);
+	    traceDumpName = argv[i + 1];
+	    i++;
+	}
 #ifndef FILESYS_STUB
 	else if (strcmp(argv[i], "-cp") == 0) {
 	    ASSERT(i + 2 < argc);
@@ -235,6 +261,7 @@ main(int argc, char **argv)
             cout << "Partial usage: nachos [-z -d debugFlags]\n";
             cout << "Partial usage: nachos [-x programName]\n";
 	    cout << "Partial usage: nachos [-K] [-C] [-N]\n";
+	    cout << "Partial usage: nachos [-tracedump traceFile]\n";
 #ifndef FILESYS_STUB
             cout << "Partial usage: nachos [-cp UnixFile NachosFile]\n";
             cout << "Partial usage: nachos [-p fileName] [-r fileName]\n";
@@ -245,6 +272,11 @@ main(int argc, char **argv)
     }
     debug = new Debug(debugArg);
     
+    if (traceDumpName != NULL) {	// just print a saved trace
+	SchedTrace::Decode(traceDumpName);
+	return 0;
+    }
+
     DEBUG(dbgThread, "Entering main");
 
     kernel = new Kernel(argc, argv);
@@ -0,0 +1,408 @@
+// multilevel.cc 
+//	Routines for the three-level scheduling policy: L1 by shortest
+//	(approximate) remaining burst, L2 by priority, L3 round robin,
+//	with aging.
+//
+// 	These routines assume that interrupts are already disabled.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation 
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "debug.h"
+#include "multilevel.h"
+#include "main.h"
+
+int SRTNCompare(Thread *a, Thread *b) {
+    if(a->getBurstTime() == b->getBurstTime())
+        return 0;
+    return a->getBurstTime() > b->getBurstTime() ? 1 : -1;
+}
+int PriorityCompare(Thread *a, Thread *b) {
+    if(a->getPriority() == b->getPriority())
+        return 0;
+    return a->getPriority() > b->getPriority() ? -1 : 1;
+}
+
+int *ReadyHandle(Thread *t) {
+    return &t->readyIndex;
+}
+
+int AgingCompare(Thread *a, Thread *b) {
+    if(a->agingTick == b->agingTick)
+        return 0;
+    return a->agingTick > b->agingTick ? 1 : -1;
+}
+int *AgingHandle(Thread *t) {
+    return &t->agingIndex;
+}
+
+//----------------------------------------------------------------------
+// Band
+//	The queue (1, 2 or 3) a thread of the given priority goes on, 
+//	for the trace -- with a ReadyQueue, the band it would be in.
+//----------------------------------------------------------------------
+static int
+Band(int priority)
+{
+    if (priority >= 100)
+        return 1;
+    if (priority >= 50)
+        return 2;
+    return 3;
+}
+
+static char *LevelName[4] = { NULL, "L1", "L2", "L3" };
+
+// a thread that has waited this long on a ready queue gets its 
+// priority raised by 10
+const int AgingTicks = 1500;
+
+//----------------------------------------------------------------------
+// AgingOrder
+//	The order Aging visits the threads that are due on the same 
+//	tick: everything in L1, then L2, then L3, each in queue order.  
+//	This is the order the queues used to be scanned in, so the
+//	trace comes out the same.
+//----------------------------------------------------------------------
+static int
+AgingOrder(MultiLevelPolicy *s, Thread *a, Thread *b)
+{
+    if (s->readyQueue != NULL)
+        return s->readyQueue->Compare(a, b);
+
+    int levelA = a->queueId;
+    int levelB = b->queueId;
+    int c = 0;
+
+    if (levelA != levelB)
+        return levelA < levelB ? -1 : 1;
+    if (levelA == 1)
+        c = SRTNCompare(a, b);
+    else if (levelA == 2)
+        c = PriorityCompare(a, b);
+    if (c != 0)
+        return c;
+    return a->readySeq < b->readySeq ? -1 : 1;
+}
+
+//----------------------------------------------------------------------
+// MultiLevelPolicy::Queued
+//	Note the order in which threads are put on (or re-sorted in)
+//	the ready queues, so that Aging can visit them in queue order.
+//----------------------------------------------------------------------
+void
+MultiLevelPolicy::Queued(Thread *thread)
+{
+    thread->readySeq = nextReadySeq++;
+}
+
+//----------------------------------------------------------------------
+// MultiLevelPolicy::StartAging
+//	Compute the tick at which a ready thread will have waited 
+//	AgingTicks, and put it on the aging queue.  The thread must 
+//	not already be on it.
+//----------------------------------------------------------------------
+void
+MultiLevelPolicy::StartAging(Thread *thread)
+{
+    thread->agingTick = thread->getReady() + AgingTicks - thread->waiting;
+    agingQueue->Insert(thread);
+}
+
+//----------------------------------------------------------------------
+//MultiLevelPolicy::Aging
+//	check the thread if it needs add priority
+//
+//	Called on every timer interrupt.  Only the threads whose
+//	aging tick has passed are looked at; they come off the front
+//	of the aging queue, are visited in queue order, and go back
+//	on with their next aging tick if they are still waiting.
+//----------------------------------------------------------------------
+void
+MultiLevelPolicy::Aging()
+{
+    int now = kernel->stats->totalTicks;
+    int i, j, n = 0;
+
+    while (!agingQueue->IsEmpty() && agingQueue->Front()->agingTick <= now) {
+        if (n == agingListSize) {
+            Thread **bigger = new Thread*[2 * agingListSize + 8];
+            for (i = 0; i < n; i++)
+                bigger[i] = agingList[i];
+            delete [] agingList;
+            agingList = bigger;
+            agingListSize = 2 * agingListSize + 8;
+        }
+        agingList[n++] = agingQueue->RemoveFront();
+    }
+
+    // put them in queue order; there are only ever a few
+    for (i = 1; i < n; i++) {
+        Thread *t = agingList[i];
+        for (j = i; j > 0 && AgingOrder(this, t, agingList[j - 1]) < 0; j--)
+            agingList[j] = agingList[j - 1];
+        agingList[j] = t;
+    }
+
+    for (i = 0; i < n; i++) {
+        Thread *t = agingList[i];
+        if (!this->CheckAge(t))		// else ReadyToRun re-armed it
+            StartAging(t);
+    }
+}
+
+//----------------------------------------------------------------------
+//MultiLevelPolicy::CheckAge
+//	raise the priority of a thread that has waited 1500 ticks, and
+//	move it to the queue its new priority belongs to.
+//	Return TRUE if the thread moved to L1.
+//----------------------------------------------------------------------
+bool
+MultiLevelPolicy::CheckAge(Thread *thread)
+{ 
+    //check thread wait for more than 1500 ticks
+    int now = kernel->stats->totalTicks;
+    int wait = now - thread->getReady() + thread->waiting;
+
+    if( wait < AgingTicks ){
+	 return FALSE;
+    }else{
+        thread->waiting = thread->waiting - AgingTicks;
+    }
+
+    //update priority
+    int oldPriority = thread->getPriority();
+    int newPriority = oldPriority + 10;
+    if( newPriority > 149) newPriority = 149;
+    thread->setPriority(newPriority);
+    if( newPriority != oldPriority){
+	kernel->schedTrace->PriorityChanged(thread, oldPriority, newPriority);
+    }
+    
+    //update queue list #L2->L1
+    if( newPriority >= 100 && oldPriority < 100 ){
+        if (readyQueue != NULL)
+            readyQueue->Remove(thread);
+        else
+            L2->Remove(thread);
+        thread->queueId = 0;
+	kernel->schedTrace->Removed(thread, "L2");
+	kernel->threadStats->Promoted(thread, 2);
+	int newwait = now - thread->getReady();
+	thread->waiting += newwait;
+	kernel->scheduler->ReadyToRun(thread);       
+        
+        return TRUE;
+    }else if( newPriority >= 50 && oldPriority < 50 ){ /* update queue list #L3->L2  */
+	kernel->schedTrace->Removed(thread, "L3");
+	kernel->threadStats->Promoted(thread, 3);
+        if (readyQueue != NULL) {
+            readyQueue->Requeue(thread);
+        } else {
+            L3->Remove(thread);
+            Queued(thread);
+            L2->Insert(thread);
+        }
+        thread->queueId = 2;
+        kernel->schedTrace->Inserted(thread, "L2");
+    }else if( readyQueue != NULL ){	// may have changed level
+        readyQueue->Requeue(thread);
+    }else if( thread->queueId == 2 ){	// priority changed within L2
+        Queued(thread);
+        L2->Update(thread);
+    }
+    return FALSE;
+}
+
+//----------------------------------------------------------------------
+// MultiLevelPolicy::MultiLevelPolicy
+// 	Initialize the queues of ready but not running threads.
+//	Initially, no ready threads.
+//
+//	"type" is which kind of ready queue to keep.  For PriorityBands,
+//	the ReadyQueue has one level sorted by burst time for 100..149
+//	(L1), one FIFO for each priority from 99 down to 50 (together, 
+//	L2 sorted by priority), and one FIFO for 0..49 (L3).
+//----------------------------------------------------------------------
+
+MultiLevelPolicy::MultiLevelPolicy(ReadyQueueType type)
+{	  
+    L1 = new Heap<Thread *>(SRTNCompare, ReadyHandle); 
+    L2 = new Heap<Thread *>(PriorityCompare, ReadyHandle);
+    L3 = new ThreadList;
+    if (type == PriorityLevels) {
+        readyQueue = new ReadyQueue(NumPriorities);
+    } else if (type == PriorityBands) {
+        readyQueue = new ReadyQueue(52);
+        readyQueue->MapPriorities(100, NumPriorities - 1, 0);
+        readyQueue->SetOrder(0, SRTNCompare);
+        for (int p = 99; p >= 50; p--)
+            readyQueue->MapPriorities(p, p, 100 - p);
+        readyQueue->MapPriorities(0, 49, 51);
+    } else {
+        readyQueue = NULL;
+    }
+    agingQueue = new Heap<Thread *>(AgingCompare, AgingHandle);
+    nextReadySeq = 0;
+    agingListSize = 0;
+    agingList = NULL;
+} 
+
+//----------------------------------------------------------------------
+// MultiLevelPolicy::~MultiLevelPolicy
+// 	De-allocate the queues of ready threads.
+//----------------------------------------------------------------------
+
+MultiLevelPolicy::~MultiLevelPolicy()
+{ 
+    delete L1;
+    delete L2;
+    delete L3; 
+    delete readyQueue;
+    delete agingQueue;
+    delete [] agingList;
+} 
+
+//----------------------------------------------------------------------
+// MultiLevelPolicy::Enqueue
+//	Put a thread on the queue for its priority, and start aging it.
+//	A thread going into L1 preempts the running thread, if that is
+//	in L2 or L3, or in L1 with a longer burst.
+//
+//	"thread" is the thread to be put on the ready list.
+//----------------------------------------------------------------------
+
+void
+MultiLevelPolicy::Enqueue(Thread *thread)
+{
+    //mp3
+    ASSERT(thread->queueId == 0);	// not queued twice
+    thread->queueId = Band(thread->getPriority());
+    Queued(thread);
+    StartAging(thread);
+
+    if (readyQueue != NULL) {
+        Thread *current = kernel->currentThread;
+
+        kernel->schedTrace->Inserted(thread, LevelName[thread->queueId]);
+        readyQueue->Append(thread);
+
+        // as below: only a thread going into L1 preempts, and only 
+        // if it would run first
+        if (thread->queueId == 1 && current->getID() != thread->getID()
+          && current->queueId != 1
+          && readyQueue->Precedes(thread, current)
+          && (Band(current->getPriority()) == 1 || current->getID() != 0)) {
+            current->setPreempt(TRUE);
+        }
+    }else if(thread->getPriority()<=49 && thread->getPriority()>=0){
+        kernel->schedTrace->Inserted(thread, "L3");
+	L3->Append(thread);
+    
+    }else if(thread->getPriority()<=99 && thread->getPriority()>=50){
+	kernel->schedTrace->Inserted(thread, "L2");
+	L2->Insert(thread);
+    
+    }else if(thread->getPriority()>=100){
+	kernel->schedTrace->Inserted(thread, "L1");
+	L1->Insert(thread);
+	
+	if(kernel->currentThread->getID()!=thread->getID() && kernel->currentThread->queueId != 1){
+	    if( kernel->currentThread->getPriority() >= 100){
+		if(kernel->currentThread->getBurstTime() > thread->getBurstTime()){
+			kernel->currentThread->setPreempt(TRUE);  
+		}
+            }else if (kernel->currentThread->getID()!=0 && kernel->currentThread->getPriority()<100){
+		kernel->currentThread->setPreempt(TRUE); 
+            }
+	}
+    }
+                                                                 
+}
+
+//----------------------------------------------------------------------
+// MultiLevelPolicy::Dequeue
+// 	Return the first thread on L1, or if that is empty L2, or L3.
+//	If there are no ready threads, return NULL.
+// Side effect:
+//	Thread is removed from the ready list.
+//----------------------------------------------------------------------
+
+Thread *
+MultiLevelPolicy::Dequeue()
+{
+    //mp3
+    int now = kernel->stats->totalTicks;    
+    Thread *next;
+    if (readyQueue != NULL) {
+        if (readyQueue->IsEmpty())
+            return NULL;
+        next = readyQueue->RemoveFront();
+        next->waiting = next->waiting + now - next->getReady();
+        kernel->schedTrace->Removed(next, LevelName[Band(next->getPriority())]);
+    } else if (L1->IsEmpty() && L2->IsEmpty() && L3->IsEmpty()) {
+		return NULL;
+    } else if(!L1->IsEmpty()) {
+        L1->Front()->waiting = L1->Front()->waiting + kernel->stats->totalTicks - L1->Front()->getReady();
+        kernel->schedTrace->Removed(L1->Front(), "L1");
+    	next = L1->RemoveFront();
+    }else if(L1->IsEmpty() && !L2->IsEmpty()) {
+        L2->Front()->waiting = L2->Front()->waiting + kernel->stats->totalTicks - L2->Front()->getReady(); 
+	kernel->schedTrace->Removed(L2->Front(), "L2");
+        next = L2->RemoveFront();
+    }else {
+        L3->Front()->waiting = L3->Front()->waiting + kernel->stats->totalTicks - L3->Front()->getReady(); 
+	kernel->schedTrace->Removed(L3->Front(), "L3");
+	next = L3->RemoveFront();
+    }
+    agingQueue->Remove(next);		// no longer waiting
+    next->queueId = 0;
+    return next;
+}
+
+//----------------------------------------------------------------------
+// MultiLevelPolicy::Tick
+//	Age the threads that have waited long enough.
+//----------------------------------------------------------------------
+
+void
+MultiLevelPolicy::Tick()
+{
+    Aging();
+}
+
+//----------------------------------------------------------------------
+// MultiLevelPolicy::CheckPreempt
+//	The running thread yields if a thread going into L1 preempted 
+//	it, or if it is in L3 (round robin) and the CPU was not idle.
+//----------------------------------------------------------------------
+
+bool
+MultiLevelPolicy::CheckPreempt(Thread *current, bool idle)
+{
+    if (current->getPreempt())
+        return TRUE;
+    return !idle && current->getPriority() <= 49;
+}
+
+//----------------------------------------------------------------------
+// MultiLevelPolicy::UpdateBurst
+//	Predict the next CPU burst of an L1 thread, from the burst
+//	that just ended -- including any part of it before it was
+//	preempted -- and the ones before (see burst.h).
+//----------------------------------------------------------------------
+
+void
+MultiLevelPolicy::UpdateBurst(Thread *thread)
+{
+    if(thread->getPriority() >= 100)
+    {
+        double running = kernel->stats->totalTicks - thread->getStart() + thread->bigT;
+        double predict = kernel->burstEstimator->Update(thread, running);
+        kernel->schedTrace->BurstUpdated(thread, thread->getBurstTime(), running, predict);
+        thread->setBurstTime(predict);
+    }
+    thread->bigT = 0;		// the burst is over, whatever our level
+}
@@ -0,0 +1,56 @@
+// multilevel.h
+//	Data structures for the three-level scheduling policy.
+//
+//	Threads are put on one of three queues by priority:
+//	   L1 (100-149)	shortest (approximate) remaining burst first,
+//			preemptive
+//	   L2 (50-99)	highest priority first, non-preemptive
+//	   L3 (0-49)	round robin
+//	A thread that has waited 1500 ticks on a ready queue gets its
+//	priority raised by 10, which may move it up a queue.  The burst
+//	time of an L1 thread is predicted from its previous bursts, by
+//	kernel->burstEstimator.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef MULTILEVEL_H
+#define MULTILEVEL_H
+
+#include "copyright.h"
+#include "schedpolicy.h"
+
+class MultiLevelPolicy : public SchedulingPolicy {
+  public:
+    MultiLevelPolicy(ReadyQueueType type);
+				// initialize the queues; "type" says
+				// which kind of ready queue to keep
+    ~MultiLevelPolicy();
+
+    void Enqueue(Thread *thread);
+    Thread *Dequeue();
+    void Tick();		// age the threads that are due
+    bool CheckPreempt(Thread *current, bool idle);
+    void UpdateBurst(Thread *thread);
+				// predict the next burst of an L1 thread
+
+    //mp3
+    ThreadList *L3;
+    Heap<Thread *> *L1;		// ordered by approximate burst time
+    Heap<Thread *> *L2;		// ordered by priority
+    ReadyQueue *readyQueue;	// used instead of L1/L2/L3, unless NULL
+
+  private:
+    Heap<Thread *> *agingQueue;	// ready threads, by agingTick
+    unsigned int nextReadySeq;	// readySeq for the next queued thread
+    Thread **agingList;		// threads due for aging on this tick
+    int agingListSize;		// number of slots in agingList
+
+    void Aging();
+    bool CheckAge(Thread* thread);
+    void Queued(Thread *thread);	// stamp a thread just put on a queue
+    void StartAging(Thread *thread);// (re)arm a ready thread's aging
+};
+
+#endif // MULTILEVEL_H
@@ -0,0 +1,214 @@
+// profile.cc
+//	Routines to read, use, update and write back the profile of
+//	each program.
+//
+// 	Seed and Learn assume that interrupts are already disabled.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "debug.h"
+#include "profile.h"
+#include "main.h"
+#include <sstream>
+
+//----------------------------------------------------------------------
+// BurstProfile::BurstProfile
+//	Read the profile from "fileName", if there is such a file.  A
+//	line written before bursts were kept has no burst mean.
+//
+//	"fileName" is where the profile is kept; NULL if it isn't
+//----------------------------------------------------------------------
+
+BurstProfile::BurstProfile(char *fileName)
+{
+    this->fileName = fileName;
+    programs = NULL;
+    numPrograms = 0;
+    size = 0;
+    if (fileName == NULL) {
+	return;
+    }
+
+    ifstream in(fileName);
+    string line;
+
+    while (getline(in, line)) {
+	istringstream fields(line);
+	string name;
+	int runs, bursts;
+	double burstTime, ioRatio, meanBurst;
+
+	if (!(fields >> name >> runs >> burstTime >> ioRatio)) {
+	    break;
+	}
+	if (!(fields >> bursts >> meanBurst)) {
+	    bursts = 0;
+	    meanBurst = 0;
+	}
+	ProgramProfile *program = Find((char *) name.c_str(), TRUE);
+
+	program->runs = runs;
+	program->burstTime = burstTime;
+	program->ioRatio = ioRatio;
+	program->bursts = bursts;
+	program->meanBurst = meanBurst;
+    }
+}
+
+//----------------------------------------------------------------------
+// BurstProfile::~BurstProfile
+//	De-allocate the profile.
+//----------------------------------------------------------------------
+
+BurstProfile::~BurstProfile()
+{
+    for (int i = 0; i < numPrograms; i++) {
+	delete [] programs[i].name;
+    }
+    delete [] programs;
+}
+
+//----------------------------------------------------------------------
+// BurstProfile::Find
+//	Return the profile of the program "name".  If there is none,
+//	make an empty one if "create", otherwise return NULL.
+//----------------------------------------------------------------------
+
+ProgramProfile *
+BurstProfile::Find(char *name, bool create)
+{
+    ProgramProfile *program;
+
+    for (int i = 0; i < numPrograms; i++) {
+	if (strcmp(programs[i].name, name) == 0) {
+	    return &programs[i];
+	}
+    }
+    if (!create) {
+	return NULL;
+    }
+    if (numPrograms == size) {		// grow the table
+	ProgramProfile *bigger = new ProgramProfile[2 * size + 4];
+
+	for (int i = 0; i < numPrograms; i++) {
+	    bigger[i] = programs[i];
+	}
+	delete [] programs;
+	programs = bigger;
+	size = 2 * size + 4;
+    }
+    program = &programs[numPrograms++];
+    program->name = new char[strlen(name) + 1];
+    strcpy(program->name, name);
+    program->runs = 0;
+    program->burstTime = 0;
+    program->ioRatio = 0;
+    program->bursts = 0;
+    program->meanBurst = 0;
+    return program;
+}
+
+//----------------------------------------------------------------------
+// BurstProfile::Seed
+//	Start a new thread off with the burst prediction its program
+//	ended up with, if we have run it before.
+//----------------------------------------------------------------------
+
+void
+BurstProfile::Seed(Thread *thread)
+{
+    ProgramProfile *program;
+
+    if (fileName == NULL) {
+	return;
+    }
+    program = Find(thread->getName(), FALSE);
+    if (program != NULL && program->runs > 0) {
+	thread->setBurstTime(program->burstTime);
+    }
+}
+
+//----------------------------------------------------------------------
+// BurstProfile::Learn
+//	"thread", a user program, is exiting.  Fold its last burst
+//	prediction (if it had any bursts predicted) and the fraction of
+//	its life it spent neither running nor ready into its program's
+//	profile; each is averaged with what we had before.
+//
+//	Called by Exit, while the thread still has its address space.
+//----------------------------------------------------------------------
+
+void
+BurstProfile::Learn(Thread *thread)
+{
+    ProgramProfile *program;
+    ThreadStatistics *s;
+    int now = kernel->stats->totalTicks;
+    int life, blocked;
+    double ioRatio;
+
+    if (fileName == NULL) {
+	return;
+    }
+    program = Find(thread->getName(), TRUE);
+    s = kernel->threadStats->Of(thread);
+    life = now - s->arrival;
+    blocked = life - s->cpuTicks - (now - thread->getStart()) - s->waitTicks;
+    ioRatio = life > 0 ? (double) blocked / life : 0;
+
+    if (program->runs == 0) {
+	program->ioRatio = ioRatio;
+    } else {
+	program->ioRatio = 0.5 * ioRatio + 0.5 * program->ioRatio;
+    }
+    if (thread->burstHistory != NULL) {
+	if (program->runs == 0) {
+	    program->burstTime = thread->getBurstTime();
+	} else {
+	    program->burstTime = 0.5 * thread->getBurstTime()
+					+ 0.5 * program->burstTime;
+	}
+    }
+    program->runs++;
+}
+
+//----------------------------------------------------------------------
+// BurstProfile::AddBurst
+//	A thread running the program "name" just had a CPU burst of
+//	"burst" ticks.  Fold it into the program's mean burst, and
+//	return the new mean.
+//----------------------------------------------------------------------
+
+double
+BurstProfile::AddBurst(char *name, double burst)
+{
+    ProgramProfile *program = Find(name, TRUE);
+
+    program->bursts++;
+    program->meanBurst += (burst - program->meanBurst) / program->bursts;
+    return program->meanBurst;
+}
+
+//----------------------------------------------------------------------
+// BurstProfile::Save
+//	Write the profile back, for the next run.
+//----------------------------------------------------------------------
+
+void
+BurstProfile::Save()
+{
+    if (fileName == NULL) {
+	return;
+    }
+
+    ofstream out(fileName);
+
+    for (int i = 0; i < numPrograms; i++) {
+	out << programs[i].name << " " << programs[i].runs << " "
+	    << programs[i].burstTime << " " << programs[i].ioRatio << " "
+	    << programs[i].bursts << " " << programs[i].meanBurst << "\n";
+    }
+}
@@ -0,0 +1,72 @@
+// profile.h
+//	Data structures for remembering, across runs, how each program
+//	behaves.
+//
+//	A new thread's predicted CPU burst starts out at 0, so for its
+//	first few bursts shortest-remaining-time-first scheduling has
+//	nothing to go on.  With "-profile <file>", the kernel reads a
+//	profile of each program it has run before -- keyed by the name
+//	it was run as -- and starts a thread running that program with
+//	the burst prediction it ended up with last time.  As each user
+//	thread exits, what it learned is folded into its program's
+//	profile, along with the fraction of its life it spent blocked
+//	(its I/O ratio); at halt the profile is written back.
+//
+//	The profile also keeps the mean of every burst each program has
+//	had, for the "history" burst estimator (see burst.h).  Without
+//	"-profile", it is only kept for this run.
+//
+//	The file has a line per program: its name, how many runs
+//	went into the profile, the learned burst, the I/O ratio, how
+//	many bursts we have seen, and their mean.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include "copyright.h"
+#include "thread.h"
+
+// What we know about one program.
+
+class ProgramProfile {
+  public:
+    char *name;			// the program
+    int runs;			// how many runs we have learned from
+    double burstTime;		// its learned burst prediction
+    double ioRatio;		// fraction of its life it spends blocked
+    int bursts;			// how many of its bursts we have seen
+    double meanBurst;		// their mean
+};
+
+class BurstProfile {
+  public:
+    BurstProfile(char *fileName);
+				// read the profile from "fileName";
+				// if NULL, don't keep one
+    ~BurstProfile();
+
+    void Seed(Thread *thread);	// start "thread" off with what we
+				// know of its program
+    void Learn(Thread *thread);	// "thread" is exiting; fold what it
+				// learned into its program's profile
+    double AddBurst(char *name, double burst);
+				// fold a burst into the mean for the
+				// program "name"; return the new mean
+    void Save();		// write the profile back
+
+  private:
+    char *fileName;		// where the profile is kept, or NULL
+    ProgramProfile *programs;	// one per program
+    int numPrograms;
+    int size;			// number of slots in programs
+
+    ProgramProfile *Find(char *name, bool create);
+				// the profile of "name"; NULL if none and
+				// not "create"
+};
+
+#endif // PROFILE_H
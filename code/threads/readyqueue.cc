@@ -0,0 +1,328 @@
+// readyqueue.cc
+//	Routines to manage a multilevel ready queue: one queue per
+//	level, and a bitmap saying which levels have threads on them.
+//
+//	Front and RemoveFront find the first non-empty level with a
+//	find-first-set on the bitmap, which looks at a word of levels
+//	at a time, so they take the same time however many threads
+//	are ready.
+//
+//	Every thread queued here is stamped with a sequence number
+//	(Thread::readySeq), so that Compare can tell which of two
+//	threads on the same FIFO level is ahead.
+//
+//     	NOTE: Mutual exclusion must be provided by the caller.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "debug.h"
+#include "readyqueue.h"
+
+//----------------------------------------------------------------------
+// QueuedHandle
+//	Where a thread on a sorted level keeps its heap index.
+//----------------------------------------------------------------------
+
+static int *
+QueuedHandle(Thread *thread)
+{
+    return &thread->readyIndex;
+}
+
+//----------------------------------------------------------------------
+// ReadyQueue::ReadyQueue
+//	Initialize a ready queue with "levels" levels, all of them
+//	empty FIFOs.  The priorities are split evenly between the
+//	levels, highest priority on level 0.
+//
+//	"levels" is the number of levels, at most NumPriorities
+//----------------------------------------------------------------------
+
+ReadyQueue::ReadyQueue(int levels)
+{
+    ASSERT(levels > 0 && levels <= NumPriorities);
+    numLevels = levels;
+    fifo = new ThreadList *[numLevels];
+    sorted = new Heap<Thread *> *[numLevels];
+    order = new ThreadCompare[numLevels];
+    for (int l = 0; l < numLevels; l++) {
+	fifo[l] = new ThreadList;
+	sorted[l] = NULL;
+	order[l] = NULL;
+    }
+    for (int p = 0; p < NumPriorities; p++) {
+	levelOf[p] = (NumPriorities - 1 - p) * numLevels / NumPriorities;
+    }
+    nonEmpty = new Bitmap(numLevels);
+    nextSeq = 0;
+}
+
+//----------------------------------------------------------------------
+// ReadyQueue::~ReadyQueue
+//	De-allocate a ready queue.  Does not delete the threads on it.
+//----------------------------------------------------------------------
+
+ReadyQueue::~ReadyQueue()
+{
+    for (int l = 0; l < numLevels; l++) {
+	delete fifo[l];
+	delete sorted[l];
+    }
+    delete [] fifo;
+    delete [] sorted;
+    delete [] order;
+    delete nonEmpty;
+}
+
+//----------------------------------------------------------------------
+// ReadyQueue::MapPriorities
+//	Put threads with priorities "low" through "high" on "level"
+//	from now on.  Should be called before any thread is queued.
+//----------------------------------------------------------------------
+
+void
+ReadyQueue::MapPriorities(int low, int high, int level)
+{
+    ASSERT(0 <= low && low <= high && high < NumPriorities);
+    ASSERT(level >= 0 && level < numLevels);
+    ASSERT(IsEmpty());
+    for (int p = low; p <= high; p++) {
+	levelOf[p] = level;
+    }
+}
+
+//----------------------------------------------------------------------
+// ReadyQueue::SetOrder
+//	Keep "level" sorted by "compare", rather than first-in
+//	first-out.  Threads that compare equal stay first-in first-out.
+//	The level must be empty.
+//----------------------------------------------------------------------
+
+void
+ReadyQueue::SetOrder(int level, ThreadCompare compare)
+{
+    ASSERT(level >= 0 && level < numLevels);
+    ASSERT(!nonEmpty->Test(level));
+    delete fifo[level];
+    fifo[level] = NULL;
+    sorted[level] = new Heap<Thread *>(compare, QueuedHandle);
+    order[level] = compare;
+}
+
+//----------------------------------------------------------------------
+// ReadyQueue::LevelOf
+//	Return the level a thread of the given priority goes on.
+//	Priorities out of range are treated as the nearest legal one.
+//----------------------------------------------------------------------
+
+int
+ReadyQueue::LevelOf(int priority)
+{
+    if (priority < 0) {
+	priority = 0;
+    } else if (priority >= NumPriorities) {
+	priority = NumPriorities - 1;
+    }
+    return levelOf[priority];
+}
+
+//----------------------------------------------------------------------
+// ReadyQueue::Append
+//	Put a thread on the level for its priority: at the back, or
+//	in sorted order if the level is sorted.
+//----------------------------------------------------------------------
+
+void
+ReadyQueue::Append(Thread *thread)
+{
+    int level = LevelOf(thread->getPriority());
+
+    ASSERT(!IsInList(thread));
+    thread->readySeq = nextSeq++;
+    thread->readyLevel = level;
+    if (sorted[level] != NULL) {
+	sorted[level]->Insert(thread);
+    } else {
+	fifo[level]->Append(thread);
+    }
+    nonEmpty->Mark(level);
+}
+
+//----------------------------------------------------------------------
+// ReadyQueue::Front
+//	Return the thread at the front of the first non-empty level,
+//	without removing it.  The queue must not be empty.
+//----------------------------------------------------------------------
+
+Thread *
+ReadyQueue::Front()
+{
+    int level = nonEmpty->FindFirstSet();
+
+    ASSERT(level != -1);
+    if (sorted[level] != NULL) {
+	return sorted[level]->Front();
+    }
+    return fifo[level]->Front();
+}
+
+//----------------------------------------------------------------------
+// ReadyQueue::RemoveFront
+//	Remove the thread that would run next, and return it.
+//	The queue must not be empty.
+//----------------------------------------------------------------------
+
+Thread *
+ReadyQueue::RemoveFront()
+{
+    Thread *thread = Front();
+
+    Remove(thread);
+    return thread;
+}
+
+//----------------------------------------------------------------------
+// ReadyQueue::Remove
+//	Take a thread, which must be queued, off its level.
+//----------------------------------------------------------------------
+
+void
+ReadyQueue::Remove(Thread *thread)
+{
+    int level = thread->readyLevel;
+    bool empty;
+
+    ASSERT(level >= 0 && level < numLevels);
+    if (sorted[level] != NULL) {
+	sorted[level]->Remove(thread);
+	empty = sorted[level]->IsEmpty();
+    } else {
+	fifo[level]->Remove(thread);
+	empty = fifo[level]->IsEmpty();
+    }
+    if (empty) {
+	nonEmpty->Clear(level);
+    }
+    thread->readyLevel = -1;
+}
+
+//----------------------------------------------------------------------
+// ReadyQueue::Requeue
+//	The priority of a queued thread has changed.  If that puts it
+//	on a different level, move it to the back of that level;
+//	otherwise leave it where it is.
+//----------------------------------------------------------------------
+
+void
+ReadyQueue::Requeue(Thread *thread)
+{
+    ASSERT(IsInList(thread));
+    if (LevelOf(thread->getPriority()) != thread->readyLevel) {
+	Remove(thread);
+	Append(thread);
+    }
+}
+
+//----------------------------------------------------------------------
+// ReadyQueue::Compare
+//	Compare two queued threads: return -1 if "x" will come off
+//	the queue before "y", 1 if after.
+//----------------------------------------------------------------------
+
+int
+ReadyQueue::Compare(Thread *x, Thread *y)
+{
+    int level = x->readyLevel;
+
+    ASSERT(IsInList(x) && IsInList(y));
+    if (level != y->readyLevel) {
+	return level < y->readyLevel ? -1 : 1;
+    }
+    if (order[level] != NULL) {
+	int c = order[level](x, y);
+	if (c != 0) {
+	    return c;
+	}
+    }
+    return x->readySeq < y->readySeq ? -1 : 1;
+}
+
+//----------------------------------------------------------------------
+// ReadyQueue::Precedes
+//	Return TRUE if "x" would be taken off the queue before "y",
+//	were both of them put on it now, "y" first.  Neither need
+//	be queued; used to decide whether "x" should preempt "y".
+//----------------------------------------------------------------------
+
+bool
+ReadyQueue::Precedes(Thread *x, Thread *y)
+{
+    int levelX = LevelOf(x->getPriority());
+    int levelY = LevelOf(y->getPriority());
+
+    if (levelX != levelY) {
+	return levelX < levelY;
+    }
+    return order[levelX] != NULL && order[levelX](x, y) < 0;
+}
+
+//----------------------------------------------------------------------
+// ReadyQueue::SelfTest
+//	Test whether this module is working: threads come out by
+//	level, in order within a sorted level and first-in first-out
+//	within a FIFO level.
+//----------------------------------------------------------------------
+
+static int
+ReadyQueueTestOrder(Thread *x, Thread *y)	// by ID, descending
+{
+    if (x->getID() == y->getID()) {
+	return 0;
+    }
+    return x->getID() > y->getID() ? -1 : 1;
+}
+
+void
+ReadyQueue::SelfTest()
+{
+    const int numThreads = 6;
+    static int priorities[numThreads] = { 10, 120, 10, 140, 60, 149 };
+    static int expected[numThreads] = { 5, 3, 1, 4, 2, 0 };
+    Thread *threads[numThreads];
+    int i;
+
+    ASSERT(numLevels == 3 && IsEmpty());	// must be a new 3-level queue
+    ASSERT(LevelOf(100) == 0 && LevelOf(99) == 1);
+    ASSERT(LevelOf(50) == 1 && LevelOf(49) == 2);
+    SetOrder(0, ReadyQueueTestOrder);
+    for (i = 0; i < numThreads; i++) {
+	threads[i] = new Thread("ready queue test", i, priorities[i]);
+	Append(threads[i]);
+	ASSERT(IsInList(threads[i]));
+    }
+    ASSERT(Compare(threads[0], threads[2]) < 0);
+    ASSERT(Precedes(threads[1], threads[4]));
+    ASSERT(Precedes(threads[3], threads[1]));
+    ASSERT(!Precedes(threads[0], threads[2]));
+
+    // moving a thread to another level puts it at the back
+    threads[0]->setPriority(60);
+    Requeue(threads[0]);
+    threads[0]->setPriority(10);
+    Requeue(threads[0]);
+    ASSERT(Compare(threads[2], threads[0]) < 0);
+
+    for (i = 0; i < numThreads; i++) {
+	Thread *next = RemoveFront();
+	ASSERT(next == threads[expected[i]]);
+	ASSERT(!IsInList(next));
+    }
+    ASSERT(IsEmpty());
+
+    for (i = 0; i < numThreads; i++) {
+	delete threads[i];
+    }
+}
@@ -0,0 +1,91 @@
+// readyqueue.h
+//	Data structures for a multilevel ready queue, in the style of
+//	the Linux "O(1)" scheduler.
+//
+//	There is one queue per level, and a bitmap with one bit per
+//	level, set when that level has a thread on it.  The next
+//	thread to run is at the front of the first non-empty level,
+//	which we find with a find-first-set on the bitmap -- so
+//	picking a thread does not depend on how many are ready.
+//	Level 0 is served first.
+//
+//	Which level a thread goes on is a function of its priority,
+//	given by a table.  Each level is a FIFO, unless it is given
+//	an order, in which case it is kept sorted (on a heap).  By
+//	default there is one FIFO per priority, 149 first.  The
+//	three-band policy (L1 by burst time, L2 by priority, L3 FIFO)
+//	is one heap level for 100..149, one FIFO per priority for
+//	50..99, and one FIFO for 0..49.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef READYQUEUE_H
+#define READYQUEUE_H
+
+#include "copyright.h"
+#include "list.h"
+#include "heap.h"
+#include "bitmap.h"
+#include "thread.h"
+
+// thread priorities run from 0 to NumPriorities-1
+const int NumPriorities = 150;
+
+// The ready queues the multilevel scheduling policy can keep: the
+// original three queues (L1 by burst time, L2 by priority, L3 round 
+// robin), a ReadyQueue with one FIFO per priority, or a ReadyQueue 
+// set up to behave like the three queues.
+enum ReadyQueueType { ThreeQueues, PriorityLevels, PriorityBands };
+
+// how a sorted level is ordered: same meaning as for SortedList
+typedef int (*ThreadCompare)(Thread *x, Thread *y);
+
+// The following class defines a multilevel ready queue.
+
+class ReadyQueue {
+  public:
+    ReadyQueue(int levels);	// initialize a queue with "levels" levels,
+				// the priorities split evenly between
+				// them, highest first
+    ~ReadyQueue();		// de-allocate the queue
+
+    void MapPriorities(int low, int high, int level);
+				// threads with priority low..high go
+				// on "level"
+    void SetOrder(int level, ThreadCompare compare);
+				// keep "level" sorted by "compare"
+				// instead of FIFO; level must be empty
+
+    void Append(Thread *thread);// put a thread on its level, at the back
+				// (or in sorted order)
+    Thread *Front();		// the thread that would run next
+    Thread *RemoveFront();	// take it off the queue
+    void Remove(Thread *thread);// take a specific thread off the queue
+    void Requeue(Thread *thread);// the priority of a queued thread
+				// changed; move it if its level did
+
+    bool IsEmpty() { return nonEmpty->FindFirstSet() == -1; }
+    bool IsInList(Thread *thread) { return thread->readyLevel != -1; }
+    int LevelOf(int priority);	// the level "priority" goes on
+    int Compare(Thread *x, Thread *y);
+				// which of two queued threads is ahead?
+    bool Precedes(Thread *x, Thread *y);
+				// would x run before y, if both were
+				// ready and queued right now?
+
+    void SelfTest();		// test whether this module is working;
+				// call on a new 3-level queue
+
+  private:
+    int numLevels;		// number of levels
+    int levelOf[NumPriorities];	// the level for each priority
+    ThreadList **fifo;		// the FIFO levels, NULL if sorted
+    Heap<Thread *> **sorted;	// the sorted levels, NULL if FIFO
+    ThreadCompare *order;	// how each sorted level is sorted
+    Bitmap *nonEmpty;		// bit "l" set if level "l" has a thread
+    unsigned int nextSeq;	// readySeq for the next queued thread
+};
+
+#endif // READYQUEUE_H
@@ -0,0 +1,452 @@
+// schedpolicy.cc
+//	Routines shared by all scheduling policies, the simpler policies
+//	(round robin, strict priority, multi-level feedback queue,
+//	lottery and stride), and the routine that makes a policy from
+//	its name.
+//
+// 	These routines assume that interrupts are already disabled.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "debug.h"
+#include "schedpolicy.h"
+#include "multilevel.h"
+#include "cfs.h"
+#include "main.h"
+
+//----------------------------------------------------------------------
+// SchedulingPolicy::CheckPreempt
+//	By default, the running thread yields only if something asked
+//	it to, by setting its preempt flag.
+//----------------------------------------------------------------------
+
+bool
+SchedulingPolicy::CheckPreempt(Thread *current, bool idle)
+{
+    return current->getPreempt();
+}
+
+//----------------------------------------------------------------------
+// SchedulingPolicy::RunTime
+//	Return how many ticks "thread" has been running since it was
+//	last dispatched.
+//----------------------------------------------------------------------
+
+int
+SchedulingPolicy::RunTime(Thread *thread)
+{
+    return kernel->stats->totalTicks - thread->getStart();
+}
+
+//----------------------------------------------------------------------
+// SchedulingPolicy::CanPreempt
+//	Return TRUE if "thread", which just became ready, may preempt
+//	"current" (if the policy would rather run it).  A thread does
+//	not preempt itself, nor a thread that is not running (the CPU
+//	is idle), nor the main thread, which has to start every user
+//	program before any of them should get ahead of it.
+//----------------------------------------------------------------------
+
+bool
+SchedulingPolicy::CanPreempt(Thread *current, Thread *thread)
+{
+    return current->getID() != thread->getID()
+	&& current->getStatus() == RUNNING && current->getID() != 0;
+}
+
+//----------------------------------------------------------------------
+// SchedulingPolicy::Inserted, SchedulingPolicy::Removed
+//	Trace a thread going on, or coming off, a ready queue, as the
+//	three-level policy does.
+//
+//	"queue" is the name of the queue
+//----------------------------------------------------------------------
+
+void
+SchedulingPolicy::Inserted(Thread *thread, char *queue)
+{
+    kernel->schedTrace->Inserted(thread, queue);
+}
+
+void
+SchedulingPolicy::Removed(Thread *thread, char *queue)
+{
+    kernel->schedTrace->Removed(thread, queue);
+}
+
+//----------------------------------------------------------------------
+// RoundRobinPolicy
+//	One FIFO; the running thread goes to the back of it on every
+//	timer interrupt.
+//----------------------------------------------------------------------
+
+RoundRobinPolicy::RoundRobinPolicy()
+{
+    readyList = new ThreadList;
+}
+
+RoundRobinPolicy::~RoundRobinPolicy()
+{
+    delete readyList;
+}
+
+void
+RoundRobinPolicy::Enqueue(Thread *thread)
+{
+    Inserted(thread, "RR");
+    readyList->Append(thread);
+}
+
+Thread *
+RoundRobinPolicy::Dequeue()
+{
+    Thread *next;
+
+    if (readyList->IsEmpty()) {
+	return NULL;
+    }
+    next = readyList->RemoveFront();
+    Removed(next, "RR");
+    return next;
+}
+
+bool
+RoundRobinPolicy::CheckPreempt(Thread *current, bool idle)
+{
+    return !idle;
+}
+
+//----------------------------------------------------------------------
+// PriorityPolicy
+//	A ReadyQueue with one FIFO per priority.  A thread that becomes
+//	ready preempts the running thread if it has a higher priority;
+//	the running thread yields at a timer interrupt if there is a
+//	ready thread with the same (or higher) priority.
+//----------------------------------------------------------------------
+
+PriorityPolicy::PriorityPolicy()
+{
+    readyQueue = new ReadyQueue(NumPriorities);
+}
+
+PriorityPolicy::~PriorityPolicy()
+{
+    delete readyQueue;
+}
+
+void
+PriorityPolicy::Enqueue(Thread *thread)
+{
+    Thread *current = kernel->currentThread;
+
+    Inserted(thread, "P");
+    readyQueue->Append(thread);
+    if (CanPreempt(current, thread) && readyQueue->Precedes(thread, current)) {
+	current->setPreempt(TRUE);
+    }
+}
+
+Thread *
+PriorityPolicy::Dequeue()
+{
+    Thread *next;
+
+    if (readyQueue->IsEmpty()) {
+	return NULL;
+    }
+    next = readyQueue->RemoveFront();
+    Removed(next, "P");
+    return next;
+}
+
+bool
+PriorityPolicy::CheckPreempt(Thread *current, bool idle)
+{
+    if (current->getPreempt()) {
+	return TRUE;
+    }
+    return !idle && !readyQueue->IsEmpty()
+	&& !readyQueue->Precedes(current, readyQueue->Front());
+}
+
+//----------------------------------------------------------------------
+// MLFQPolicy
+//	Three FIFOs.  A thread's time slice on queue i is MLFQSlice[i]
+//	timer interrupts; once it has used that up -- over however many
+//	bursts -- it moves down a queue.  Every MLFQBoostTicks, every
+//	ready or running thread goes back to the top.
+//----------------------------------------------------------------------
+
+static const int MLFQSlice[MLFQLevels] = { 1, 2, 4 };
+static char *MLFQName[MLFQLevels] = { "Q0", "Q1", "Q2" };
+const int MLFQBoostTicks = 5000;
+
+MLFQPolicy::MLFQPolicy()
+{
+    for (int i = 0; i < MLFQLevels; i++) {
+	queue[i] = new ThreadList;
+    }
+    lastBoost = 0;
+}
+
+MLFQPolicy::~MLFQPolicy()
+{
+    for (int i = 0; i < MLFQLevels; i++) {
+	delete queue[i];
+    }
+}
+
+void
+MLFQPolicy::Enqueue(Thread *thread)
+{
+    Thread *current = kernel->currentThread;
+    int level = thread->schedLevel;
+
+    Inserted(thread, MLFQName[level]);
+    queue[level]->Append(thread);
+    if (CanPreempt(current, thread) && level < current->schedLevel) {
+	current->setPreempt(TRUE);
+    }
+}
+
+Thread *
+MLFQPolicy::Dequeue()
+{
+    for (int i = 0; i < MLFQLevels; i++) {
+	if (!queue[i]->IsEmpty()) {
+	    Thread *next = queue[i]->RemoveFront();
+	    Removed(next, MLFQName[i]);
+	    return next;
+	}
+    }
+    return NULL;
+}
+
+//----------------------------------------------------------------------
+// MLFQPolicy::Tick
+//	Charge the running thread for one timer interrupt's worth of
+//	its time slice, and demote it if the slice is used up.  Boost
+//	everyone, if it is time.
+//----------------------------------------------------------------------
+
+void
+MLFQPolicy::Tick()
+{
+    Thread *current = kernel->currentThread;
+
+    if (kernel->stats->totalTicks - lastBoost >= MLFQBoostTicks) {
+	Boost();
+    }
+    if (current->getStatus() != RUNNING) {	// CPU is idle
+	return;
+    }
+    current->sliceUsed++;
+    if (current->sliceUsed >= MLFQSlice[current->schedLevel]) {
+	if (current->schedLevel < MLFQLevels - 1) {
+	    current->schedLevel++;
+	}
+	current->sliceUsed = 0;
+	current->setPreempt(TRUE);
+    }
+}
+
+void
+MLFQPolicy::Boost()
+{
+    Thread *current = kernel->currentThread;
+
+    for (int i = 1; i < MLFQLevels; i++) {
+	while (!queue[i]->IsEmpty()) {
+	    Thread *thread = queue[i]->RemoveFront();
+	    Removed(thread, MLFQName[i]);
+	    thread->schedLevel = 0;
+	    thread->sliceUsed = 0;
+	    Inserted(thread, MLFQName[0]);
+	    queue[0]->Append(thread);
+	}
+    }
+    current->schedLevel = 0;
+    current->sliceUsed = 0;
+    lastBoost = kernel->stats->totalTicks;
+}
+
+//----------------------------------------------------------------------
+// LotteryPolicy
+//	A list of ready threads and the number of tickets they hold
+//	between them.  Each timer interrupt holds a new draw.
+//----------------------------------------------------------------------
+
+static int
+Tickets(Thread *thread)
+{
+    int priority = thread->getPriority();
+
+    if (priority < 0) {
+	priority = 0;
+    } else if (priority >= NumPriorities) {
+	priority = NumPriorities - 1;
+    }
+    return priority + 1;
+}
+
+LotteryPolicy::LotteryPolicy()
+{
+    readyList = new ThreadList;
+    totalTickets = 0;
+}
+
+LotteryPolicy::~LotteryPolicy()
+{
+    delete readyList;
+}
+
+void
+LotteryPolicy::Enqueue(Thread *thread)
+{
+    Inserted(thread, "LOTTERY");
+    readyList->Append(thread);
+    totalTickets += Tickets(thread);
+}
+
+Thread *
+LotteryPolicy::Dequeue()
+{
+    ThreadListIterator iter(readyList);
+    Thread *winner = NULL;
+    int ticket;
+
+    if (readyList->IsEmpty()) {
+	return NULL;
+    }
+    ticket = kernel->replay->Input(ReplayRandom, RandomNumber() % totalTickets);
+    for (; !iter.IsDone(); iter.Next()) {
+	winner = iter.Item();
+	ticket -= Tickets(winner);
+	if (ticket < 0) {
+	    break;
+	}
+    }
+    readyList->Remove(winner);
+    totalTickets -= Tickets(winner);
+    Removed(winner, "LOTTERY");
+    return winner;
+}
+
+bool
+LotteryPolicy::CheckPreempt(Thread *current, bool idle)
+{
+    return !idle;
+}
+
+//----------------------------------------------------------------------
+// StridePolicy
+//	A heap of ready threads by pass.  A thread's pass goes up by
+//	NumPriorities/tickets for each tick it runs, so a thread with
+//	twice the tickets runs twice as long.  A thread that has been
+//	away (asleep, or new) comes back no further behind than the
+//	last thread dispatched, so it cannot monopolize the CPU to
+//	catch up.
+//----------------------------------------------------------------------
+
+static int
+PassCompare(Thread *x, Thread *y)
+{
+    if (x->vruntime == y->vruntime) {
+	return 0;
+    }
+    return x->vruntime > y->vruntime ? 1 : -1;
+}
+
+static int *
+PassHandle(Thread *thread)
+{
+    return &thread->readyIndex;
+}
+
+StridePolicy::StridePolicy()
+{
+    readyHeap = new Heap<Thread *>(PassCompare, PassHandle);
+    minPass = 0;
+}
+
+StridePolicy::~StridePolicy()
+{
+    delete readyHeap;
+}
+
+void
+StridePolicy::Charge(Thread *thread)
+{
+    thread->vruntime += RunTime(thread) * (double) NumPriorities
+						/ Tickets(thread);
+}
+
+void
+StridePolicy::Enqueue(Thread *thread)
+{
+    if (thread == kernel->currentThread) {	// yielding
+	Charge(thread);
+    } else if (thread->vruntime < minPass) {
+	thread->vruntime = minPass;
+    }
+    Inserted(thread, "STRIDE");
+    readyHeap->Insert(thread);
+}
+
+Thread *
+StridePolicy::Dequeue()
+{
+    Thread *next;
+
+    if (readyHeap->IsEmpty()) {
+	return NULL;
+    }
+    next = readyHeap->RemoveFront();
+    minPass = next->vruntime;
+    Removed(next, "STRIDE");
+    return next;
+}
+
+bool
+StridePolicy::CheckPreempt(Thread *current, bool idle)
+{
+    return !idle;
+}
+
+void
+StridePolicy::UpdateBurst(Thread *thread)
+{
+    Charge(thread);
+}
+
+//----------------------------------------------------------------------
+// NewSchedulingPolicy
+//	Make the scheduling policy called "name".  Return NULL if there
+//	is no policy by that name.
+//
+//	"type" is which ready queue the multilevel policy should keep
+//----------------------------------------------------------------------
+
+SchedulingPolicy *
+NewSchedulingPolicy(char *name, ReadyQueueType type)
+{
+    if (strcmp(name, "multilevel") == 0) {
+	return new MultiLevelPolicy(type);
+    } else if (strcmp(name, "rr") == 0) {
+	return new RoundRobinPolicy();
+    } else if (strcmp(name, "priority") == 0) {
+	return new PriorityPolicy();
+    } else if (strcmp(name, "mlfq") == 0) {
+	return new MLFQPolicy();
+    } else if (strcmp(name, "cfs") == 0) {
+	return new CFSPolicy();
+    } else if (strcmp(name, "lottery") == 0) {
+	return new LotteryPolicy();
+    } else if (strcmp(name, "stride") == 0) {
+	return new StridePolicy();
+    }
+    return NULL;
+}
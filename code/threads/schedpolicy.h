@@ -0,0 +1,171 @@
+// schedpolicy.h
+//	Data structures for scheduling policies.
+//
+//	The Scheduler does the mechanics of dispatching: marking threads
+//	ready, switching to the next one, cleaning up after threads that
+//	finish.  Which ready thread runs next, and when the running thread
+//	should give up the CPU, is decided by a SchedulingPolicy.  Each
+//	policy sees:
+//
+//	   Enqueue	a thread became ready (it was woken up, forked,
+//			or it is the running thread, yielding)
+//	   Dequeue	pick the thread to run next
+//	   Tick		a timer interrupt went off
+//	   CheckPreempt	should the running thread yield when the
+//			timer interrupt returns?
+//	   UpdateBurst	the running thread is going to sleep, at the
+//			end of a CPU burst
+//	   Report	Nachos is halting; print any statistics
+//
+//	The policy is picked with "-sched <name>" on the command line;
+//	the default, "multilevel", is the three-level queue (see
+//	multilevel.h).
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef SCHEDPOLICY_H
+#define SCHEDPOLICY_H
+
+#include "copyright.h"
+#include "list.h"
+#include "heap.h"
+#include "thread.h"
+#include "readyqueue.h"
+
+// The following class defines the interface every scheduling policy
+// provides.  All of these are called with interrupts disabled.
+
+class SchedulingPolicy {
+  public:
+    virtual ~SchedulingPolicy() {}
+
+    virtual void Enqueue(Thread *thread) = 0;
+				// "thread" is ready to run
+    virtual Thread *Dequeue() = 0;
+				// take the thread to run next off the
+				// ready queue; NULL if there is none
+    virtual void Tick() {}	// a timer interrupt went off
+    virtual bool CheckPreempt(Thread *current, bool idle);
+				// should "current" yield when the timer
+				// interrupt returns?  "idle" if the CPU
+				// was idle when it went off
+    virtual void UpdateBurst(Thread *thread) {}
+				// "thread" is going to sleep, at the
+				// end of a CPU burst
+    virtual void Report() {}	// print statistics, at halt
+
+  protected:
+    int RunTime(Thread *thread);// ticks since "thread" was dispatched
+    bool CanPreempt(Thread *current, Thread *thread);
+				// may "thread" becoming ready preempt
+				// "current"?
+    void Inserted(Thread *thread, char *queue);
+    void Removed(Thread *thread, char *queue);
+				// trace a thread going on or off a queue
+};
+
+// Round robin: one FIFO queue, and the running thread yields at
+// every timer interrupt.
+
+class RoundRobinPolicy : public SchedulingPolicy {
+  public:
+    RoundRobinPolicy();
+    ~RoundRobinPolicy();
+
+    void Enqueue(Thread *thread);
+    Thread *Dequeue();
+    bool CheckPreempt(Thread *current, bool idle);
+
+  private:
+    ThreadList *readyList;	// threads ready to run, in order
+};
+
+// Strict priority: the highest priority ready thread always runs,
+// round robin among equals.  A thread that becomes ready preempts
+// a lower priority one.  Threads are not aged, so low priority
+// threads can starve.
+
+class PriorityPolicy : public SchedulingPolicy {
+  public:
+    PriorityPolicy();
+    ~PriorityPolicy();
+
+    void Enqueue(Thread *thread);
+    Thread *Dequeue();
+    bool CheckPreempt(Thread *current, bool idle);
+
+  private:
+    ReadyQueue *readyQueue;	// one FIFO per priority
+};
+
+// Multi-level feedback queue: every thread starts on the top queue.
+// A thread that uses up its time slice on a queue moves down one;
+// lower queues have longer slices.  Every so often, every ready
+// thread is moved back to the top, so nothing starves.
+
+const int MLFQLevels = 3;		// number of queues
+
+class MLFQPolicy : public SchedulingPolicy {
+  public:
+    MLFQPolicy();
+    ~MLFQPolicy();
+
+    void Enqueue(Thread *thread);
+    Thread *Dequeue();
+    void Tick();		// charge the running thread's time slice
+
+  private:
+    ThreadList *queue[MLFQLevels];	// queue[0] runs first
+    int lastBoost;			// when we last moved everyone up
+
+    void Boost();			// move every thread to queue 0
+};
+
+// Lottery: every ready thread holds priority+1 tickets, and at each
+// timer interrupt a random ticket picks the thread to run next.
+
+class LotteryPolicy : public SchedulingPolicy {
+  public:
+    LotteryPolicy();
+    ~LotteryPolicy();
+
+    void Enqueue(Thread *thread);
+    Thread *Dequeue();
+    bool CheckPreempt(Thread *current, bool idle);
+
+  private:
+    ThreadList *readyList;	// threads holding tickets
+    int totalTickets;		// sum of their tickets
+};
+
+// Stride: the deterministic version of lottery.  Each thread has a
+// "pass" (Thread::vruntime), which goes up by its stride -- inversely
+// proportional to its tickets -- for every tick it runs.  The ready
+// thread with the lowest pass runs next.
+
+class StridePolicy : public SchedulingPolicy {
+  public:
+    StridePolicy();
+    ~StridePolicy();
+
+    void Enqueue(Thread *thread);
+    Thread *Dequeue();
+    bool CheckPreempt(Thread *current, bool idle);
+    void UpdateBurst(Thread *thread);
+
+  private:
+    Heap<Thread *> *readyHeap;	// ready threads, lowest pass first
+    double minPass;		// pass of the last thread dispatched
+
+    void Charge(Thread *thread);// add the ticks "thread" just ran
+};
+
+// Make the policy called "name" ("multilevel", "rr", "priority",
+// "mlfq", "cfs", "lottery" or "stride"), or return NULL if there is
+// no such policy.  "type" is the ready queue multilevel should keep.
+extern SchedulingPolicy *NewSchedulingPolicy(char *name,
+					ReadyQueueType type);
+
+#endif // SCHEDPOLICY_H
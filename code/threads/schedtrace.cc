@@ -0,0 +1,315 @@
+// schedtrace.cc
+//	Routines to record scheduling events in a binary ring, save
+//	them to a file, and print them back as text.
+//
+// 	The recording routines assume that interrupts are already
+//	disabled.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "debug.h"
+#include "schedtrace.h"
+#include "main.h"
+
+// The first word of every chunk of a trace file.
+const int TraceMagic = 0x4e545243;	// "NTRC"
+
+//----------------------------------------------------------------------
+// SchedTrace::SchedTrace
+//	Initialize an empty ring, and open the trace file, if any.
+//
+//	"fileName" is where to save every event; NULL not to save them
+//----------------------------------------------------------------------
+
+SchedTrace::SchedTrace(char *fileName)
+{
+    next = 0;
+    count = 0;
+    numQueues = 0;
+    fd = fileName == NULL ? -1 : OpenForWrite(fileName);
+    live = debug->IsEnabled(z);
+    recording = fd >= 0 || live;
+    ring = recording ? new SchedEvent[TraceSize] : NULL;
+}
+
+//----------------------------------------------------------------------
+// SchedTrace::~SchedTrace
+//	Save what is left in the ring, and close the trace file.
+//----------------------------------------------------------------------
+
+SchedTrace::~SchedTrace()
+{
+    if (fd >= 0) {
+	Flush();
+	Close(fd);
+    }
+    delete [] ring;
+}
+
+//----------------------------------------------------------------------
+// SchedTrace::QueueId
+//	Return the index of the name of "queue".  Queue names are
+//	string constants, so we know one by its address; failing that,
+//	by its contents.  A new name is copied into the table.
+//----------------------------------------------------------------------
+
+int
+SchedTrace::QueueId(char *queue)
+{
+    for (int i = 0; i < numQueues; i++) {
+	if (keys[i] == queue) {
+	    return i;
+	}
+    }
+    for (int i = 0; i < numQueues; i++) {
+	if (strcmp(names[i], queue) == 0) {
+	    return i;
+	}
+    }
+    ASSERT(numQueues < TraceQueues);
+    ASSERT(strlen(queue) < TraceNameSize);
+    strcpy(names[numQueues], queue);
+    keys[numQueues] = queue;
+    return numQueues++;
+}
+
+//----------------------------------------------------------------------
+// SchedTrace::NewEvent
+//	Return the next slot in the ring, filled in with what every
+//	event has.
+//----------------------------------------------------------------------
+
+SchedEvent *
+SchedTrace::NewEvent(char type, Thread *thread)
+{
+    SchedEvent *event = &ring[next];
+
+    event->type = type;
+    event->tick = kernel->stats->totalTicks;
+    event->thread = thread->getID();
+    return event;
+}
+
+//----------------------------------------------------------------------
+// SchedTrace::Recorded
+//	"event", the next slot in the ring, is filled in.  Print it, if
+//	we are asked to, and move on; if the ring is full and we are
+//	saving events, write it out.
+//----------------------------------------------------------------------
+
+void
+SchedTrace::Recorded(SchedEvent *event)
+{
+    if (live) {
+	Print(event, names, cerr);
+    }
+    next = (next + 1) % TraceSize;
+    if (count < TraceSize) {
+	count++;
+    }
+    if (count == TraceSize && fd >= 0) {
+	Flush();
+    }
+}
+
+//----------------------------------------------------------------------
+// SchedTrace::Inserted, SchedTrace::Removed
+//	Record a thread going on, or coming off, a ready queue.
+//
+//	"queue" is the name of the queue
+//----------------------------------------------------------------------
+
+void
+SchedTrace::Inserted(Thread *thread, char *queue)
+{
+    SchedEvent *event;
+
+    if (!recording) {
+	return;
+    }
+    event = NewEvent('A', thread);
+    event->queue = QueueId(queue);
+    Recorded(event);
+}
+
+void
+SchedTrace::Removed(Thread *thread, char *queue)
+{
+    SchedEvent *event;
+
+    if (!recording) {
+	return;
+    }
+    event = NewEvent('B', thread);
+    event->queue = QueueId(queue);
+    Recorded(event);
+}
+
+//----------------------------------------------------------------------
+// SchedTrace::PriorityChanged
+//	Record a change in a thread's priority.
+//----------------------------------------------------------------------
+
+void
+SchedTrace::PriorityChanged(Thread *thread, int oldPriority, int newPriority)
+{
+    SchedEvent *event;
+
+    if (!recording) {
+	return;
+    }
+    event = NewEvent('C', thread);
+    event->oldValue = oldPriority;
+    event->newValue = newPriority;
+    Recorded(event);
+}
+
+//----------------------------------------------------------------------
+// SchedTrace::BurstUpdated
+//	Record a new prediction of a thread's CPU burst.
+//
+//	"ran" is the length of the burst that just ended
+//----------------------------------------------------------------------
+
+void
+SchedTrace::BurstUpdated(Thread *thread, double oldBurst, double ran,
+							double newBurst)
+{
+    SchedEvent *event;
+
+    if (!recording) {
+	return;
+    }
+    event = NewEvent('D', thread);
+    event->oldBurst = oldBurst;
+    event->ran = ran;
+    event->newBurst = newBurst;
+    Recorded(event);
+}
+
+//----------------------------------------------------------------------
+// SchedTrace::Switched
+//	Record a context switch to "nextThread".
+//
+//	"oldRun" is how long "oldThread" ran
+//----------------------------------------------------------------------
+
+void
+SchedTrace::Switched(Thread *nextThread, Thread *oldThread, int oldRun)
+{
+    SchedEvent *event;
+
+    if (!recording) {
+	return;
+    }
+    event = NewEvent('E', nextThread);
+    event->oldValue = oldThread->getID();
+    event->newValue = oldRun;
+    Recorded(event);
+}
+
+//----------------------------------------------------------------------
+// SchedTrace::Flush
+//	Write the events in the ring, oldest first, to the trace file
+//	as one chunk, headed by the queue names; empty the ring.
+//----------------------------------------------------------------------
+
+void
+SchedTrace::Flush()
+{
+    int first = (next - count + TraceSize) % TraceSize;
+    int magic = TraceMagic;
+
+    if (count == 0) {
+	return;
+    }
+    WriteFile(fd, (char *) &magic, sizeof(int));
+    WriteFile(fd, (char *) &numQueues, sizeof(int));
+    WriteFile(fd, (char *) names, numQueues * TraceNameSize);
+    WriteFile(fd, (char *) &count, sizeof(int));
+    if (first + count <= TraceSize) {
+	WriteFile(fd, (char *) &ring[first], count * sizeof(SchedEvent));
+    } else {
+	WriteFile(fd, (char *) &ring[first],
+			(TraceSize - first) * sizeof(SchedEvent));
+	WriteFile(fd, (char *) ring, next * sizeof(SchedEvent));
+    }
+    count = 0;
+}
+
+//----------------------------------------------------------------------
+// SchedTrace::Print
+//	Print "event" in the same words the scheduler has always used.
+//
+//	"names" are the names of the queues
+//----------------------------------------------------------------------
+
+void
+SchedTrace::Print(SchedEvent *event, char names[][TraceNameSize],
+							ostream &out)
+{
+    out << "[" << event->type << "] Tick [" << event->tick << "]: Thread ["
+	<< event->thread << "] ";
+    switch (event->type) {
+      case 'A':
+	out << "is inserted into queue " << names[event->queue];
+	break;
+      case 'B':
+	out << "is removed from queue " << names[event->queue];
+	break;
+      case 'C':
+	out << "changes its priority from [" << event->oldValue << "] to ["
+	    << event->newValue << "]";
+	break;
+      case 'D':
+	out << "update approximate burst time, from: [" << event->oldBurst
+	    << "], add [" << event->ran << "], to [" << event->newBurst << "]";
+	break;
+      case 'E':
+	out << "is now selected for execution, thread [" << event->oldValue
+	    << "] is replaced, and it has executed [" << event->newValue
+	    << "] ticks";
+	break;
+      default:
+	ASSERTNOTREACHED();
+    }
+    out << "\n";
+}
+
+//----------------------------------------------------------------------
+// SchedTrace::Decode
+//	Print every event in the trace file "fileName" as text, on
+//	stdout.
+//----------------------------------------------------------------------
+
+void
+SchedTrace::Decode(char *fileName)
+{
+    int fd = OpenForReadWrite(fileName, FALSE);
+    char names[TraceQueues][TraceNameSize];
+    SchedEvent *events = new SchedEvent[TraceSize];
+    int magic, numQueues, numEvents;
+
+    if (fd < 0) {
+	cerr << "Unable to open trace file " << fileName << "\n";
+	delete [] events;
+	return;
+    }
+    while (ReadPartial(fd, (char *) &magic, sizeof(int)) == sizeof(int)) {
+	ASSERT(magic == TraceMagic);
+	Read(fd, (char *) &numQueues, sizeof(int));
+	ASSERT(numQueues >= 0 && numQueues <= TraceQueues);
+	Read(fd, (char *) names, numQueues * TraceNameSize);
+	Read(fd, (char *) &numEvents, sizeof(int));
+	ASSERT(numEvents > 0 && numEvents <= TraceSize);
+	Read(fd, (char *) events, numEvents * sizeof(SchedEvent));
+	for (int i = 0; i < numEvents; i++) {
+	    Print(&events[i], names, cout);
+	}
+    }
+    Close(fd);
+    delete [] events;
+}
@@ -0,0 +1,99 @@
+// schedtrace.h
+//	Data structures for tracing scheduling events.
+//
+//	The scheduler reports every thread going on or off a ready
+//	queue ([A], [B]), every priority change ([C]), every burst
+//	prediction ([D]) and every context switch ([E]).  Formatting
+//	each of these as text, as it happens, costs more than the
+//	scheduling itself, so instead each is stored as a small binary
+//	record in a fixed-size ring; nothing is allocated, or formatted,
+//	once Nachos is running.
+//
+//	With "-trace <file>", every event is saved to the file, a
+//	ringful at a time; "nachos -tracedump <file>" prints it back
+//	as the same text "-d z" would have printed.  With "-d z", the
+//	text is still printed as each event happens, as before.  With
+//	neither, nothing would ever read the ring, so nothing is recorded.
+//
+//	The file is in the host's byte order, and meant to be read by
+//	the Nachos that wrote it.  It is a series of chunks, one per
+//	flush: the names of the queues seen so far, then the events.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef SCHEDTRACE_H
+#define SCHEDTRACE_H
+
+#include "copyright.h"
+#include "utility.h"
+#include "sysdep.h"
+#include "thread.h"
+
+const int TraceSize = 1024;		// events in the ring
+const int TraceQueues = 32;		// distinct queue names we can trace
+const int TraceNameSize = 16;		// longest queue name, with the '\0'
+
+// One scheduling event.  Which fields mean anything depends on
+// the type:
+//	'A', 'B'  thread went on, came off, queue "queue"
+//	'C'	  thread's priority changed from oldValue to newValue
+//	'D'	  thread's predicted burst went from oldBurst to
+//		  newBurst, after a burst of "ran"
+//	'E'	  thread was switched to, from thread oldValue, which
+//		  had run for newValue ticks
+
+class SchedEvent {
+  public:
+    char type;			// 'A' through 'E'
+    short queue;		// index into the queue names
+    int tick;			// when it happened
+    int thread;			// ID of the thread it happened to
+    int oldValue;
+    int newValue;
+    double oldBurst;
+    double ran;
+    double newBurst;
+};
+
+class SchedTrace {
+  public:
+    SchedTrace(char *fileName);	// empty ring; save every event to
+				// "fileName", unless it is NULL
+    ~SchedTrace();		// flush the ring to the file
+
+    void Inserted(Thread *thread, char *queue);
+    void Removed(Thread *thread, char *queue);
+    void PriorityChanged(Thread *thread, int oldPriority, int newPriority);
+    void BurstUpdated(Thread *thread, double oldBurst, double ran,
+							double newBurst);
+    void Switched(Thread *nextThread, Thread *oldThread, int oldRun);
+
+    static void Decode(char *fileName);
+				// print a trace file as text
+
+  private:
+    SchedEvent *ring;		// the last TraceSize events
+    int next;			// where the next event goes
+    int count;			// events in the ring
+    char names[TraceQueues][TraceNameSize];
+				// names of the queues seen so far
+    char *keys[TraceQueues];	// the strings they were seen as
+    int numQueues;
+    int fd;			// the trace file, or -1
+    bool live;			// print events as they happen?
+    bool recording;		// is there a file, or are we live?
+				// if not, events are ignored
+
+    int QueueId(char *queue);	// the index of "queue"'s name
+    SchedEvent *NewEvent(char type, Thread *thread);
+    void Recorded(SchedEvent *event);
+				// print it or flush, as needed
+    void Flush();		// write the ring to the file
+
+    static void Print(SchedEvent *event,
+			char names[][TraceNameSize], ostream &out);
+};
+
+#endif // SCHEDTRACE_H
@@ -11,8 +11,9 @@
 //	end up calling FindNextToRun(), and that would put us in an 
 //	infinite loop.
 //
-// 	Very simple implementation -- no priorities, straight FIFO.
-//	Might need to be improved in later assignments.
+// 	Which ready thread runs next is up to the SchedulingPolicy
+//	the scheduler was made with (see schedpolicy.h); here we just
+//	keep track of ready threads and switch between them.
 //
 // Copyright (c) 1992-1996 The Regents of the University of California.
 // All rights reserved.  See copyright.h for copyright notice and limitation 
@@ -23,102 +24,18 @@
 #include "scheduler.h"
 #include "main.h"
 
-
-int SRTNCompare(Thread *a, Thread *b) {
-    if(a->getBurstTime() == b->getBurstTime())
-        return 0;
-    return a->getBurstTime() > b->getBurstTime() ? 1 : -1;
-}
-int PriorityCompare(Thread *a, Thread *b) {
-    if(a->getPriority() == b->getPriority())
-        return 0;
-    return a->getPriority() > b->getPriority() ? -1 : 1;
-}
-
-//----------------------------------------------------------------------
-//Scheduler::Aging
-//	check the thread if it needs add priority
-//----------------------------------------------------------------------
-void
-Scheduler::Aging()
-{
-    ListIterator<Thread *> *iter1 = new ListIterator<Thread *>(L1);
-    ListIterator<Thread *> *iter2 = new ListIterator<Thread *>(L2);
-    ListIterator<Thread *> *iter3 = new ListIterator<Thread *>(L3);
-
-    while(!iter1->IsDone()){ 
-        Thread* t = iter1->Item(); 
-        this->CheckAge(t); 
-        iter1->Next();
-    }
-
-    while(!iter2->IsDone()){
-        Thread* t = iter2->Item();
-        L2->Remove(t);                                                                                       
-	bool aging = this->CheckAge(t);   
-	if(!aging) L2->Insert(t);                                                                    
-	iter2->Next(); 
-    }
-    //because  list3 does not use sortedList so do not remove the thread
-    while(!iter3->IsDone()){                                                          
-        Thread* t = iter3->Item();       
-        this->CheckAge(t);
-        iter3->Next(); 
-    }	
-  //  CheckAge(kernel->currentThread);
-}
-
-bool
-Scheduler::CheckAge(Thread *thread)
-{ 
-    //check thread wait for more than 1500 ticks
-    int now = kernel->stats->totalTicks;
-    int wait = now - thread->getReady() + thread->waiting;
-
-    if( wait < 1500 ){
-	 return FALSE;
-    }else{
-        thread->waiting = thread->waiting - 1500;
-    }
-
-    //update priority
-    int oldPriority = thread->getPriority();
-    int newPriority = oldPriority + 10;
-    if( newPriority > 149) newPriority = 149;
-    thread->setPriority(newPriority);
-    if( newPriority != oldPriority){
-	DEBUG(z,"[C] Tick ["<<now<<"]: Thread ["<<thread->getID()<<"] changes its priority from ["<<oldPriority<<"] to ["<<newPriority<<"]");
-    }
-    
-    //update queue list #L2->L1
-    if( newPriority >= 100 && oldPriority < 100 ){
-	DEBUG(z,"[B] Tick ["<<now<<"]: Thread ["<<thread->getID()<<"] is removed from queue L2");    
-	int newwait = now - thread->getReady();
-	thread->waiting += newwait;
-	kernel->scheduler->ReadyToRun(thread);       
-        
-        return TRUE;
-    }else if( newPriority >= 50 && oldPriority < 50 ){ /* update queue list #L3->L2  */
-        L3->Remove(thread);
-	DEBUG(z,"[B] Tick ["<<now<<"]: Thread ["<<thread->getID()<<"] is removed from queue L3");
-        L2->Insert(thread);
-        DEBUG(z,"[A] Tick ["<<now<<"]: Thread ["<<thread->getID()<<"] is inserted into queue L2");        
-    }
-    return FALSE;
-}
-
 //----------------------------------------------------------------------
 // Scheduler::Scheduler
 // 	Initialize the list of ready but not running threads.
 //	Initially, no ready threads.
+//
+//	"policy" decides which of them runs next; the scheduler 
+//	deletes it when done.
 //----------------------------------------------------------------------
 
-Scheduler::Scheduler()
+Scheduler::Scheduler(SchedulingPolicy *policy)
 {	  
-    L1 = new SortedList<Thread *>(SRTNCompare); 
-    L2 = new SortedList<Thread *>(PriorityCompare);
-    L3 = new List<Thread *>;
-   // readyList = new List<Thread *>; 
+    this->policy = policy;
     toBeDestroyed = NULL;
 } 
 
@@ -129,9 +46,7 @@ Scheduler::Scheduler()
 
 Scheduler::~Scheduler()
 { 
-    delete L1;
-    delete L2;
-    delete L3; 
+    delete policy;
 } 
 
 //----------------------------------------------------------------------
@@ -148,35 +63,12 @@ Scheduler::ReadyToRun (Thread *thread)
     ASSERT(kernel->interrupt->getLevel() == IntOff);
     DEBUG(dbgThread, "Putting thread on ready list: " << thread->getName());
 	//cout << "Putting thread on ready list: " << thread->getName() << endl ;
+    kernel->threadStats->Ready(thread);
     thread->setStatus(READY);
     
     //mp3
-    int now = kernel->stats->totalTicks;
-    thread->setReady(now);
-
-    if(thread->getPriority()<=49 && thread->getPriority()>=0){
-        DEBUG(z,"[A] Tick [" << now << "]: Thread [" << thread->getID() << "] is inserted into queue L3");
-	L3->Append(thread);
-    
-    }else if(thread->getPriority()<=99 && thread->getPriority()>=50){
-	DEBUG(z,"[A] Tick [" << now << "]: Thread [" << thread->getID() << "] is inserted into queue L2");
-	L2->Insert(thread);
-    
-    }else if(thread->getPriority()>=100){
-	DEBUG(z,"[A] Tick [" << now << "]: Thread [" << thread->getID() << "] is inserted into queue L1");
-	L1->Insert(thread);
-	
-	if(kernel->currentThread->getID()!=thread->getID() && !L1->IsInList(kernel->currentThread)){
-	    if( kernel->currentThread->getPriority() >= 100){
-		if(kernel->currentThread->getBurstTime() > thread->getBurstTime()){
-			kernel->currentThread->setPreempt(TRUE);  
-		}
-            }else if (kernel->currentThread->getID()!=0 && kernel->currentThread->getPriority()<100){
-		kernel->currentThread->setPreempt(TRUE); 
-            }
-	}
-    }
-                                                                 
+    thread->setReady(kernel->stats->totalTicks);
+    policy->Enqueue(thread);
 }
 
 //----------------------------------------------------------------------
@@ -190,25 +82,65 @@ Scheduler::ReadyToRun (Thread *thread)
 Thread *
 Scheduler::FindNextToRun ()
 {
+    Thread *next;
+
     ASSERT(kernel->interrupt->getLevel() == IntOff);
     
-    //mp3
-    int now = kernel->stats->totalTicks;    
-    if (L1->IsEmpty() && L2->IsEmpty() && L3->IsEmpty()) {
-		return NULL;
-    } else if(!L1->IsEmpty()) {
-        L1->Front()->waiting = L1->Front()->waiting + kernel->stats->totalTicks - L1->Front()->getReady();
-        DEBUG(z,"[B] Tick [" << now << "]: Thread [" << L1->Front()->getID() << "] is removed from queue L1");
-    	return L1->RemoveFront();
-    }else if(L1->IsEmpty() && !L2->IsEmpty()) {
-        L2->Front()->waiting = L2->Front()->waiting + kernel->stats->totalTicks - L2->Front()->getReady(); 
-	DEBUG(z,"[B] Tick [" << now << "]: Thread [" << L2->Front()->getID() << "] is removed from queue L2");   
-        return L2->RemoveFront();
-    }else if(L1->IsEmpty() && L2->IsEmpty() && !L3->IsEmpty()) {
-        L3->Front()->waiting = L3->Front()->waiting + kernel->stats->totalTicks - L3->Front()->getReady(); 
-	DEBUG(z,"[B] Tick [" << now << "]: Thread [" << L3->Front()->getID() << "] is removed from queue L3");   
-	return L3->RemoveFront();
-   }
+    next = policy->Dequeue();
+    if (next != NULL) {
+	kernel->threadStats->Dispatched(next);
+    }
+    return next;
+}
+
+//----------------------------------------------------------------------
+// Scheduler::Tick
+// 	Called on every timer interrupt, with interrupts disabled, to 
+//	let the policy do its bookkeeping (aging, time slices, ...).
+//----------------------------------------------------------------------
+
+void
+Scheduler::Tick()
+{
+    policy->Tick();
+}
+
+//----------------------------------------------------------------------
+// Scheduler::CheckPreempt
+// 	Return TRUE if the running thread should yield the CPU when the
+//	timer interrupt returns.
+//
+//	"idle" is set if the CPU was idle when the interrupt went off
+//----------------------------------------------------------------------
+
+bool
+Scheduler::CheckPreempt(bool idle)
+{
+    return policy->CheckPreempt(kernel->currentThread, idle);
+}
+
+//----------------------------------------------------------------------
+// Scheduler::UpdateBurst
+// 	Called when "thread", the running thread, is about to sleep, at
+//	the end of its CPU burst.
+//----------------------------------------------------------------------
+
+void
+Scheduler::UpdateBurst(Thread *thread)
+{
+    policy->UpdateBurst(thread);
+}
+
+//----------------------------------------------------------------------
+// Scheduler::Report
+// 	Print whatever statistics the policy keeps, when we've finished
+//	everything at system shutdown.
+//----------------------------------------------------------------------
+
+void
+Scheduler::Report()
+{
+    policy->Report();
 }
 
 //----------------------------------------------------------------------
@@ -238,8 +170,10 @@ Scheduler::Run (Thread *nextThread, bool finishing)
     //mp3
     int now = kernel->stats->totalTicks;
     int oldRun =  now - oldThread->getStart();
+    kernel->replay->Ran(nextThread->getID());	// log, or check, the choice
+    kernel->threadStats->Switched(oldThread, nextThread, finishing);
     nextThread->setStart(now);
-    DEBUG(z,"[E] Tick [" << now << "]: Thread [" << nextThread->getID() <<"] is now selected for execution, thread [" << oldThread->getID() <<"] is replaced, and it has executed [" << oldRun << "] ticks");
+    kernel->schedTrace->Switched(nextThread, oldThread, oldRun);
     
     
     if (finishing) {	// mark that we need to delete current thread
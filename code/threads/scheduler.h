@@ -12,13 +12,16 @@
 #include "copyright.h"
 #include "list.h"
 #include "thread.h"
+#include "schedpolicy.h"
 
 // The following class defines the scheduler/dispatcher abstraction -- 
 // the data structures and operations needed to keep track of which 
 // thread is running, and which threads are ready but not running.
 class Scheduler{
   public:
-    Scheduler();		// Initialize list of ready threads 
+    Scheduler(SchedulingPolicy *policy);
+				// Initialize list of ready threads,
+				// chosen between by "policy"
     ~Scheduler();		// De-allocate ready list
 
     void ReadyToRun(Thread* thread);	
@@ -30,22 +33,17 @@ class Scheduler{
     void CheckToBeDestroyed();// Check if thread that had been
     				// running needs to be deleted
     void Print();		// Print contents of ready list
+
+    void Tick();		// a timer interrupt went off
+    bool CheckPreempt(bool idle);// should the running thread yield?
+    void UpdateBurst(Thread *thread);
+    				// thread is about to sleep
+    void Report();		// print the policy's statistics
     
     // SelfTest for scheduler is implemented in class Thread
 
-    //mp3
-    List<Thread *> *L3;
-    SortedList<Thread *> *L1;
-    SortedList<Thread *> *L2;
-   
-    void Aging();
-    bool CheckAge(Thread* thread);
   private:
-   // List<Thread *> *L3;
-   // SortedList<Thread *> *L1;
-   // SortedList<Thread *> *L2; 
-//    List<Thread *> *readyList;  // queue of threads that are ready to run,
-				// but not running
+    SchedulingPolicy *policy;	// decides which ready thread runs
     Thread *toBeDestroyed;	// finishing thread to be destroyed
     				// by the next thread that runs
 };
@@ -48,7 +48,7 @@ Semaphore::Semaphore(char* debugName, int initialValue)
 {
     name = debugName;
     value = initialValue;
-    queue = new List<Thread *>;
+    queue = new ThreadList;
 }
 
 //----------------------------------------------------------------------
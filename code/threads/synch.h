@@ -50,7 +50,7 @@ class Semaphore {
   private:
     char* name;        // useful for debugging
     int value;         // semaphore value, always >= 0
-    List<Thread *> *queue;     
+    ThreadList *queue;     
 		  	// threads waiting in P() for the value to be > 0
    };
 
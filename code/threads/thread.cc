@@ -46,7 +46,24 @@ Thread::Thread(char* threadName, int threadID)
 					// of machine registers
     }
     space = NULL;
-     
+    priority = 0;			// the scheduling fields, as for
+    burstTime = 0;			// a user thread of priority 0
+    start = 0;
+    ready = 0;
+    bigT = 0;
+    waiting = 0;
+    preempt = FALSE;
+    readyIndex = -1;
+    readyLevel = -1;
+    queueId = 0;
+    readySeq = 0;
+    agingTick = 0;
+    agingIndex = -1;
+    schedLevel = 0;
+    sliceUsed = 0;
+    vruntime = 0;
+    statsIndex = -1;
+    burstHistory = NULL;
 }
 Thread::Thread(char* threadName, int threadID, int priority)
 {
@@ -68,6 +85,17 @@ Thread::Thread(char* threadName, int threadID, int priority)
     this->bigT = 0;
     this->waiting = 0;
     this->setPreempt(FALSE);
+    this->readyIndex = -1;
+    this->readyLevel = -1;
+    this->queueId = 0;
+    this->readySeq = 0;
+    this->agingTick = 0;
+    this->agingIndex = -1;
+    this->schedLevel = 0;
+    this->sliceUsed = 0;
+    this->vruntime = 0;
+    this->statsIndex = -1;
+    this->burstHistory = NULL;
 }
 //----------------------------------------------------------------------
 // Thread::~Thread
@@ -85,6 +113,8 @@ Thread::~Thread()
 {
     DEBUG(dbgThread, "Deleting thread: " << name);
     ASSERT(this != kernel->currentThread);
+    ASSERT(queueHook.list == NULL);		// not on any queue
+    kernel->threadTable->Release(this);		// our ID may be reused
     if (stack != NULL)
 	DeallocBoundedArray((char *) stack, StackSize * sizeof(int));
 }
@@ -229,7 +259,7 @@ Thread::Yield ()
     DEBUG(dbgThread, "Yielding thread: " << name);
     //mp3
     double running = kernel->stats->totalTicks - this->getStart();
-    this->bigT = running;
+    this->bigT += running;		// our burst is not over yet
     //current thread is now be preempted
     kernel->currentThread->setPreempt(FALSE);
     
@@ -238,6 +268,9 @@ Thread::Yield ()
     nextThread = kernel->scheduler->FindNextToRun();
 
     if (nextThread != NULL) {
+	if (nextThread != this) {
+	    kernel->threadStats->Preempted(this);
+	}
 //	kernel->scheduler->ReadyToRun(this);
 	kernel->scheduler->Run(nextThread, FALSE);
     }
@@ -278,12 +311,9 @@ Thread::Sleep (bool finishing)
 
     status = BLOCKED;
 
-    if(this->getPriority() >= 100)
-    {
-        double running = kernel->stats->totalTicks - this->getStart() + this->bigT;
-        double predict = 0.5 * running + 0.5 * this->getBurstTime();
-        DEBUG(z,"[D] Tick ["<<kernel->stats->totalTicks<<"]: Thread ["<<this->getID()<<"] update approximate burst time, from: ["<< this->getBurstTime() <<"], add ["<<running<<"], to ["<<predict<<"]");
-        this->setBurstTime(predict);      this->bigT = 0;
+    kernel->scheduler->UpdateBurst(this);	// our CPU burst is over
+    if (!finishing) {
+	kernel->threadStats->Slept(this);
     }
    
     //cout << "debug Thread::Sleep " << name << "wait for Idle\n";
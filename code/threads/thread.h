@@ -42,6 +42,7 @@
 #include "sysdep.h"
 #include "machine.h"
 #include "addrspace.h"
+#include "intrusivelist.h"
 
 // CPU register state to be saved on context switch.  
 // The x86 needs to save only a few registers, 
@@ -73,6 +74,8 @@ enum ThreadStatus { JUST_CREATED, RUNNING, READY, BLOCKED, ZOMBIE };
 //  Some threads also belong to a user address space; threads
 //  that only run in the kernel have a NULL address space.
 
+class BurstHistory;
+
 class Thread {
   private:
     // NOTE: DO NOT CHANGE the order of these first two members.
@@ -106,6 +109,31 @@ class Thread {
 
     double bigT;   
     int waiting;
+    int readyIndex;		// where we are on the L1/L2 ready heap,
+				// -1 if we are not on one
+    int readyLevel;		// which level of the ready queue we are
+				// on, -1 if we are not on one
+    int queueId;		// multilevel: which band (1, 2 or 3,
+				// for L1..L3) we are queued in, 0 if
+				// we are not queued
+    ListHook<Thread> queueHook;	// our links on the ThreadList we are
+				// on: a ready queue, or a semaphore's
+				// waiters
+    unsigned int readySeq;	// when we were queued, relative to the
+				// other ready threads
+    int agingTick;		// tick at which we have waited long 
+				// enough to be aged
+    int agingIndex;		// where we are on the aging heap,
+				// -1 if we are not on it
+    int schedLevel;		// MLFQ: the queue we belong on
+    int sliceUsed;		// MLFQ: timer interrupts we have run
+				// for on that queue
+    double vruntime;		// CFS, stride: how much (weighted) CPU
+				// time we have had
+    int statsIndex;		// our slot in kernel->threadStats,
+				// -1 until we have one
+    BurstHistory *burstHistory;	// our past CPU bursts, NULL until
+				// the first one ends
     // basic thread operations
 
     void Fork(VoidFunctionPtr func, void *arg); 
@@ -152,6 +180,11 @@ class Thread {
     AddrSpace *space;			// User code this thread is running.
 };
 
+// A list of threads, linked through their queueHook -- so a thread
+// is on at most one at a time.
+typedef IntrusiveList<Thread, &Thread::queueHook> ThreadList;
+typedef IntrusiveListIterator<Thread, &Thread::queueHook> ThreadListIterator;
+
 // external function, dummy routine whose sole job is to call Thread::Print
 extern void ThreadPrint(Thread *thread);	 
 
@@ -0,0 +1,318 @@
+// threadstats.cc
+//	Routines for keeping, and writing out, per thread scheduling
+//	statistics.
+//
+// 	These routines assume that interrupts are already disabled.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "threadstats.h"
+#include "main.h"
+
+//----------------------------------------------------------------------
+// ThreadStatTable::ThreadStatTable
+//	Initialize an empty table.
+//
+//	"fileName" is where to write the table at halt; NULL if nowhere
+//	"policyName" is the scheduling policy in use
+//----------------------------------------------------------------------
+
+ThreadStatTable::ThreadStatTable(char *fileName, char *policyName)
+{
+    this->fileName = fileName;
+    this->policyName = policyName;
+    table = NULL;
+    numThreads = 0;
+    size = 0;
+}
+
+//----------------------------------------------------------------------
+// ThreadStatTable::~ThreadStatTable
+//	De-allocate the table, and the names in it.
+//----------------------------------------------------------------------
+
+ThreadStatTable::~ThreadStatTable()
+{
+    for (int i = 0; i < numThreads; i++) {
+	delete [] table[i].name;
+    }
+    delete [] table;
+}
+
+//----------------------------------------------------------------------
+// ThreadStatTable::Of
+//	Return the statistics for "thread".  If this is the first we
+//	have seen of it, give it a new slot: it arrives now.
+//----------------------------------------------------------------------
+
+ThreadStatistics *
+ThreadStatTable::Of(Thread *thread)
+{
+    ThreadStatistics *s;
+
+    if (thread->statsIndex >= 0) {
+	return &table[thread->statsIndex];
+    }
+    if (numThreads == size) {		// grow the table
+	ThreadStatistics *bigger = new ThreadStatistics[2 * size + 8];
+
+	for (int i = 0; i < numThreads; i++) {
+	    bigger[i] = table[i];
+	}
+	delete [] table;
+	table = bigger;
+	size = 2 * size + 8;
+    }
+    thread->statsIndex = numThreads++;
+    s = &table[thread->statsIndex];
+    s->id = thread->getID();
+    s->name = new char[strlen(thread->getName()) + 1];
+    strcpy(s->name, thread->getName());
+    s->priority = thread->getPriority();
+    s->arrival = kernel->stats->totalTicks;
+    s->firstRun = -1;
+    s->completion = -1;
+    s->cpuTicks = 0;
+    s->waitTicks = 0;
+    s->preemptions = 0;
+    s->sleeps = 0;
+    s->l3ToL2 = 0;
+    s->l2ToL1 = 0;
+    s->burstTime = 0;
+    return s;
+}
+
+//----------------------------------------------------------------------
+// ThreadStatTable::Ready
+//	"thread" is going on the ready queue.  If it was already on it
+//	(aging is moving it to another queue), it has been waiting
+//	since it last went on.
+//----------------------------------------------------------------------
+
+void
+ThreadStatTable::Ready(Thread *thread)
+{
+    ThreadStatistics *s = Of(thread);
+
+    if (thread->getStatus() == READY) {
+	s->waitTicks += kernel->stats->totalTicks - thread->getReady();
+    }
+}
+
+//----------------------------------------------------------------------
+// ThreadStatTable::Dispatched
+//	"thread" is coming off the ready queue, to run: it has been
+//	waiting since it went on.
+//----------------------------------------------------------------------
+
+void
+ThreadStatTable::Dispatched(Thread *thread)
+{
+    ThreadStatistics *s = Of(thread);
+    int now = kernel->stats->totalTicks;
+
+    s->waitTicks += now - thread->getReady();
+    if (s->firstRun < 0) {
+	s->firstRun = now;
+    }
+}
+
+//----------------------------------------------------------------------
+// ThreadStatTable::Switched
+//	The CPU is going from "oldThread", which has had it since it
+//	was dispatched, to "nextThread".
+//
+//	"finishing" is set if oldThread is done
+//----------------------------------------------------------------------
+
+void
+ThreadStatTable::Switched(Thread *oldThread, Thread *nextThread,
+							bool finishing)
+{
+    ThreadStatistics *s = Of(oldThread);
+    int now = kernel->stats->totalTicks;
+
+    s->cpuTicks += now - oldThread->getStart();
+    s->priority = oldThread->getPriority();
+    s->burstTime = oldThread->getBurstTime();
+    if (finishing) {
+	s->completion = now;
+    }
+}
+
+//----------------------------------------------------------------------
+// ThreadStatTable::Preempted, ThreadStatTable::Slept,
+// ThreadStatTable::Promoted
+//	Count the ways "thread" can give up the CPU, or move up.
+//----------------------------------------------------------------------
+
+void
+ThreadStatTable::Preempted(Thread *thread)
+{
+    Of(thread)->preemptions++;
+}
+
+void
+ThreadStatTable::Slept(Thread *thread)
+{
+    Of(thread)->sleeps++;
+}
+
+void
+ThreadStatTable::Promoted(Thread *thread, int fromLevel)
+{
+    if (fromLevel == 3) {
+	Of(thread)->l3ToL2++;
+    } else {
+	ASSERT(fromLevel == 2);
+	Of(thread)->l2ToL1++;
+    }
+}
+
+//----------------------------------------------------------------------
+// ThreadStatTable::Print
+//	Write the table out, if we were asked to, at system shutdown:
+//	as CSV if the file name ends in ".csv", otherwise as JSON.
+//	"-" is stdout.
+//----------------------------------------------------------------------
+
+void
+ThreadStatTable::Print()
+{
+    int len;
+    bool csv;
+
+    if (fileName == NULL) {
+	return;
+    }
+    len = strlen(fileName);
+    csv = len >= 4 && strcmp(fileName + len - 4, ".csv") == 0;
+    if (strcmp(fileName, "-") == 0) {
+	WriteJSON(cout);
+	return;
+    }
+
+    ofstream out(fileName);
+    if (!out) {
+	cerr << "Unable to write thread statistics to " << fileName << "\n";
+	return;
+    }
+    if (csv) {
+	WriteCSV(out);
+    } else {
+	WriteJSON(out);
+    }
+}
+
+//----------------------------------------------------------------------
+// Turnaround, Response
+//	Derived times for a thread; -1 if it never finished, or never
+//	ran.
+//----------------------------------------------------------------------
+
+static int
+Turnaround(ThreadStatistics *s)
+{
+    return s->completion < 0 ? -1 : s->completion - s->arrival;
+}
+
+static int
+Response(ThreadStatistics *s)
+{
+    return s->firstRun < 0 ? -1 : s->firstRun - s->arrival;
+}
+
+//----------------------------------------------------------------------
+// WriteString
+//	Write "str" as a JSON string.
+//----------------------------------------------------------------------
+
+static void
+WriteString(ostream &out, char *str)
+{
+    out << '"';
+    for (; *str != '\0'; str++) {
+	if (*str == '"' || *str == '\\') {
+	    out << '\\' << *str;
+	} else if ((unsigned char) *str < ' ') {
+	    out << ' ';
+	} else {
+	    out << *str;
+	}
+    }
+    out << '"';
+}
+
+//----------------------------------------------------------------------
+// ThreadStatTable::WriteJSON
+//	Write the table as one JSON object: the policy, the run as a
+//	whole, and an array with an object per thread.  Throughput is
+//	threads completed per 1000 ticks.
+//----------------------------------------------------------------------
+
+void
+ThreadStatTable::WriteJSON(ostream &out)
+{
+    int total = kernel->stats->totalTicks;
+    int completed = 0;
+
+    for (int i = 0; i < numThreads; i++) {
+	if (table[i].completion >= 0) {
+	    completed++;
+	}
+    }
+    out << "{\n  \"policy\": ";
+    WriteString(out, policyName);
+    out << ",\n  \"totalTicks\": " << total
+	<< ",\n  \"completed\": " << completed
+	<< ",\n  \"throughput\": "
+	<< (total > 0 ? completed * 1000.0 / total : 0.0)
+	<< ",\n  \"threads\": [";
+    for (int i = 0; i < numThreads; i++) {
+	ThreadStatistics *s = &table[i];
+
+	out << (i == 0 ? "\n" : ",\n") << "    {\"id\": " << s->id
+	    << ", \"name\": ";
+	WriteString(out, s->name);
+	out << ", \"priority\": " << s->priority
+	    << ", \"arrival\": " << s->arrival
+	    << ", \"firstRun\": " << s->firstRun
+	    << ", \"completion\": " << s->completion
+	    << ", \"cpuTicks\": " << s->cpuTicks
+	    << ", \"waitTicks\": " << s->waitTicks
+	    << ", \"preemptions\": " << s->preemptions
+	    << ", \"sleeps\": " << s->sleeps
+	    << ", \"l3ToL2\": " << s->l3ToL2
+	    << ", \"l2ToL1\": " << s->l2ToL1
+	    << ", \"burstTime\": " << s->burstTime
+	    << ", \"turnaround\": " << Turnaround(s)
+	    << ", \"response\": " << Response(s) << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+//----------------------------------------------------------------------
+// ThreadStatTable::WriteCSV
+//	Write the table as CSV: a header line, then a line per thread.
+//----------------------------------------------------------------------
+
+void
+ThreadStatTable::WriteCSV(ostream &out)
+{
+    out << "policy,id,name,priority,arrival,firstRun,completion,cpuTicks,"
+	<< "waitTicks,preemptions,sleeps,l3ToL2,l2ToL1,burstTime,"
+	<< "turnaround,response\n";
+    for (int i = 0; i < numThreads; i++) {
+	ThreadStatistics *s = &table[i];
+
+	out << policyName << "," << s->id << "," << s->name << ","
+	    << s->priority << "," << s->arrival << "," << s->firstRun << ","
+	    << s->completion << "," << s->cpuTicks << "," << s->waitTicks
+	    << "," << s->preemptions << "," << s->sleeps << "," << s->l3ToL2
+	    << "," << s->l2ToL1 << "," << s->burstTime << ","
+	    << Turnaround(s) << "," << Response(s) << "\n";
+    }
+}
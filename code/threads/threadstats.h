@@ -0,0 +1,86 @@
+// threadstats.h
+//	Data structures for keeping scheduling statistics per thread.
+//
+//	Statistics (machine/stats.h) only counts for the machine as a
+//	whole.  Here we keep, for every thread that ever became ready:
+//	when it arrived, first ran, and finished; how long it ran and
+//	how long it waited on the ready queue; how often it was
+//	preempted or went to sleep; and how often aging moved it up a
+//	queue (L3->L2, L2->L1).
+//
+//	A thread is gone by the time Nachos halts, so its numbers are
+//	kept in a table of its own; Thread::statsIndex is its slot.
+//	Slots are never reused, so a thread ID may show up twice.
+//
+//	With "-stats <file>", the table is written out at halt, along
+//	with the derived turnaround, response time and throughput: as
+//	CSV if the file name ends in ".csv", as JSON otherwise; "-"
+//	is stdout.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef THREADSTATS_H
+#define THREADSTATS_H
+
+#include "copyright.h"
+#include "utility.h"
+#include "sysdep.h"
+#include "thread.h"
+
+// What we know about one thread.  Ticks not yet seen are -1.
+
+class ThreadStatistics {
+  public:
+    int id;			// the thread's ID
+    char *name;			// a copy of its name
+    int priority;		// its priority, when last seen
+    int arrival;		// tick it first became ready
+    int firstRun;		// tick it was first dispatched
+    int completion;		// tick it finished
+    int cpuTicks;		// ticks it held the CPU
+    int waitTicks;		// ticks it spent on the ready queue
+    int preemptions;		// times it was made to yield
+    int sleeps;			// times it went to sleep
+    int l3ToL2;			// times aging moved it from L3 to L2
+    int l2ToL1;			// times aging moved it from L2 to L1
+    double burstTime;		// its last predicted CPU burst
+};
+
+class ThreadStatTable {
+  public:
+    ThreadStatTable(char *fileName, char *policyName);
+				// empty table; write it to "fileName"
+				// (if not NULL) at halt
+    ~ThreadStatTable();
+
+    ThreadStatistics *Of(Thread *thread);
+				// the statistics for "thread"; a new
+				// thread arrives now
+
+    void Ready(Thread *thread);	// "thread" is going on the ready queue
+    void Dispatched(Thread *thread);
+				// "thread" is coming off it, to run
+    void Switched(Thread *oldThread, Thread *nextThread, bool finishing);
+				// the CPU goes from oldThread to nextThread
+    void Preempted(Thread *thread);
+    void Slept(Thread *thread);
+    void Promoted(Thread *thread, int fromLevel);
+				// aging moved "thread" up from L3 (3)
+				// or L2 (2)
+
+    void Print();		// write out the table, if asked to
+
+  private:
+    ThreadStatistics *table;	// one per thread, in order of arrival
+    int numThreads;		// how many slots are in use
+    int size;			// how many slots there are
+    char *fileName;		// where to write the table, or NULL
+    char *policyName;		// the scheduling policy, for the record
+
+    void WriteJSON(ostream &out);
+    void WriteCSV(ostream &out);
+};
+
+#endif // THREADSTATS_H
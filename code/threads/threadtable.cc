@@ -0,0 +1,124 @@
+// threadtable.cc
+//	Routines to hand out thread IDs, and to find threads by ID.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "debug.h"
+#include "threadtable.h"
+
+//----------------------------------------------------------------------
+// ThreadTable::ThreadTable
+//	Initialize an empty table; no IDs handed out yet.
+//----------------------------------------------------------------------
+
+ThreadTable::ThreadTable()
+{
+    size = 16;
+    threads = new Thread *[size];
+    freeIDs = new int[size];
+    for (int i = 0; i < size; i++) {
+	threads[i] = NULL;
+    }
+    nextID = 0;
+    numFree = 0;
+    numInUse = 0;
+}
+
+//----------------------------------------------------------------------
+// ThreadTable::~ThreadTable
+//	De-allocate the table.
+//----------------------------------------------------------------------
+
+ThreadTable::~ThreadTable()
+{
+    delete [] threads;
+    delete [] freeIDs;
+}
+
+//----------------------------------------------------------------------
+// ThreadTable::Allocate
+//	Return an ID no registered thread has: the one most recently
+//	released, if any, otherwise a new one.  Double the table if the
+//	new ID does not fit.
+//----------------------------------------------------------------------
+
+int
+ThreadTable::Allocate()
+{
+    if (numFree > 0) {
+	return freeIDs[--numFree];
+    }
+    if (nextID == size) {		// grow the table; no IDs are free
+	Thread **bigger = new Thread *[2 * size];
+	int *biggerFree = new int[2 * size];
+
+	for (int i = 0; i < 2 * size; i++) {
+	    bigger[i] = i < size ? threads[i] : NULL;
+	}
+	delete [] threads;
+	delete [] freeIDs;
+	threads = bigger;
+	freeIDs = biggerFree;
+	size *= 2;
+    }
+    return nextID++;
+}
+
+//----------------------------------------------------------------------
+// ThreadTable::Register
+//	Put "thread" in the table, under its ID, which came from
+//	Allocate.
+//----------------------------------------------------------------------
+
+void
+ThreadTable::Register(Thread *thread)
+{
+    int id = thread->getID();
+
+    ASSERT(id >= 0 && id < nextID && threads[id] == NULL);
+    threads[id] = thread;
+    numInUse++;
+}
+
+//----------------------------------------------------------------------
+// ThreadTable::Release
+//	Take "thread" out of the table, if it is there, and let its ID
+//	be used again.  Threads made for tests, with made-up IDs, were
+//	never put in the table; we leave the table alone for those.
+//
+//	ID 0 is main's, and is never reused: the scheduling policies
+//	treat thread 0 as main, which starts the others, even after it
+//	has finished and programs are still arriving.
+//----------------------------------------------------------------------
+
+void
+ThreadTable::Release(Thread *thread)
+{
+    int id = thread->getID();
+
+    if (Get(id) != thread) {
+	return;
+    }
+    threads[id] = NULL;
+    if (id != 0) {
+	freeIDs[numFree++] = id;
+    }
+    numInUse--;
+}
+
+//----------------------------------------------------------------------
+// ThreadTable::Get
+//	Return the thread with ID "id", or NULL if there is none.
+//----------------------------------------------------------------------
+
+Thread *
+ThreadTable::Get(int id)
+{
+    if (id < 0 || id >= nextID) {
+	return NULL;
+    }
+    return threads[id];
+}
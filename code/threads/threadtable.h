@@ -0,0 +1,47 @@
+// threadtable.h
+//	Data structures for the table of threads, by ID.
+//
+//	The kernel hands out thread IDs from here, and finds a thread
+//	by its ID here, in constant time.  The table grows as needed,
+//	so there is no limit on the number of threads, and the ID of a
+//	thread that has been deleted is handed out again, most recently
+//	freed first, so IDs stay small.  The exception is ID 0, main's,
+//	which is never handed out again.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef THREADTABLE_H
+#define THREADTABLE_H
+
+#include "copyright.h"
+#include "thread.h"
+
+class ThreadTable {
+  public:
+    ThreadTable();		// empty table
+    ~ThreadTable();		// de-allocate the table; does not
+				// delete the threads in it
+
+    int Allocate();		// return an unused ID
+    void Register(Thread *thread);
+				// "thread", with an ID from Allocate,
+				// is now in use
+    void Release(Thread *thread);
+				// "thread" is being deleted; its ID
+				// may be reused
+
+    Thread *Get(int id);	// the thread with ID "id", or NULL
+    int NumInUse() { return numInUse; }
+
+  private:
+    Thread **threads;		// threads[id] is the thread, or NULL
+    int size;			// number of slots in threads
+    int nextID;			// lowest ID never handed out
+    int *freeIDs;		// IDs to reuse, as a stack
+    int numFree;		// number of IDs on the stack
+    int numInUse;		// number of threads registered
+};
+
+#endif // THREADTABLE_H
@@ -0,0 +1,248 @@
+// workload.cc
+//	Routines to collect the user programs to run, and start them
+//	when they arrive.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "debug.h"
+#include "workload.h"
+#include "main.h"
+#include <math.h>
+
+//----------------------------------------------------------------------
+// Workload::Workload
+//	Initialize an empty workload.
+//----------------------------------------------------------------------
+
+Workload::Workload()
+{
+    jobs = NULL;
+    numJobs = 0;
+    size = 0;
+    next = 0;
+    randomState = 1;
+}
+
+//----------------------------------------------------------------------
+// Workload::~Workload
+//	De-allocate the jobs.
+//----------------------------------------------------------------------
+
+Workload::~Workload()
+{
+    for (int i = 0; i < numJobs; i++) {
+	delete [] jobs[i].name;
+    }
+    delete [] jobs;
+}
+
+//----------------------------------------------------------------------
+// Workload::Add
+//	Add a job, after the ones already added.  The jobs are kept in
+//	an array, not a List, so adding thousands of them stays cheap.
+//
+//	"name" is the program to run
+//	"priority" is the priority to run it at
+//	"arrival" is the tick to start it at
+//----------------------------------------------------------------------
+
+void
+Workload::Add(char *name, int priority, int arrival)
+{
+    Job *job;
+
+    if (numJobs == size) {		// grow the array
+	Job *bigger = new Job[2 * size + 4];
+
+	for (int i = 0; i < numJobs; i++) {
+	    bigger[i] = jobs[i];
+	}
+	delete [] jobs;
+	jobs = bigger;
+	size = 2 * size + 4;
+    }
+    job = &jobs[numJobs++];
+    job->name = new char[strlen(name) + 1];
+    strcpy(job->name, name);
+    job->priority = priority;
+    job->arrival = arrival;
+    job->order = numJobs - 1;
+}
+
+//----------------------------------------------------------------------
+// Workload::ReadJobFile
+//	Add the jobs in "fileName", one per line, as
+//	"<program> <priority> <arrival tick>".  The priority and arrival
+//	may be left off; they default to 0.  Return FALSE if the file
+//	can't be opened.
+//----------------------------------------------------------------------
+
+bool
+Workload::ReadJobFile(char *fileName)
+{
+    ifstream in(fileName);
+    string line;
+
+    if (!in) {
+	return FALSE;
+    }
+    while (getline(in, line)) {
+	char *name = new char[line.size() + 1];
+	int priority = 0, arrival = 0;
+
+	if (sscanf(line.c_str(), "%s %d %d", name, &priority, &arrival) >= 1
+		&& name[0] != '#') {
+	    Add(name, priority, arrival);
+	}
+	delete [] name;
+    }
+    return TRUE;
+}
+
+//----------------------------------------------------------------------
+// Workload::Generate
+//	Add the jobs a generator makes (see workload.h): "count" runs
+//	of "name", at "priority", arriving from tick 0 on at a mean rate
+//	of one every "gap" ticks.  Return FALSE if "spec" is not
+//	"poisson:<count>:<gap>[:<seed>]" or "bursty:<count>:<gap>[:<seed>]".
+//
+//	Without a seed, the generator carries on from the random
+//	numbers of the one before.
+//----------------------------------------------------------------------
+
+bool
+Workload::Generate(char *spec, char *name, int priority)
+{
+    char kind[16];
+    int count, gap;
+    unsigned int seed;
+    int fields = sscanf(spec, "%15[a-z]:%d:%d:%u", kind, &count, &gap, &seed);
+    int tick = 0;
+
+    if (fields < 3 || count <= 0 || gap <= 0) {
+	return FALSE;
+    }
+    if (fields == 4) {
+	randomState = seed;
+    }
+    if (strcmp(kind, "poisson") == 0) {
+	for (int i = 0; i < count; i++) {
+	    tick += Exponential(gap);
+	    Add(name, priority, tick);
+	}
+    } else if (strcmp(kind, "bursty") == 0) {
+	double meanBurst = (1 + BurstyMaxBurst) / 2.0;
+
+	for (int i = 0; i < count; ) {
+	    int burst = 1 + (int) (Uniform() * BurstyMaxBurst);
+
+	    tick += Exponential(gap * meanBurst);
+	    for (int j = 0; j < burst && i < count; j++, i++) {
+		Add(name, priority, tick);
+	    }
+	}
+    } else {
+	return FALSE;
+    }
+    return TRUE;
+}
+
+//----------------------------------------------------------------------
+// Workload::Uniform
+//	Return a random number in [0, 1), from the generators' own
+//	linear congruential generator.
+//----------------------------------------------------------------------
+
+double
+Workload::Uniform()
+{
+    randomState = randomState * 1103515245 + 12345;
+    return ((randomState >> 8) & 0xffffff) / (double) 0x1000000;
+}
+
+//----------------------------------------------------------------------
+// Workload::Exponential
+//	Return a random gap, in ticks, exponentially distributed with
+//	mean "mean".
+//----------------------------------------------------------------------
+
+int
+Workload::Exponential(double mean)
+{
+    return (int) (-mean * log(1.0 - Uniform()) + 0.5);
+}
+
+//----------------------------------------------------------------------
+// JobCompare
+//	Order jobs by arrival; jobs arriving together, in the order
+//	they were added.
+//----------------------------------------------------------------------
+
+static int
+JobCompare(const void *x, const void *y)
+{
+    const Job *a = (const Job *) x;
+    const Job *b = (const Job *) y;
+
+    if (a->arrival != b->arrival) {
+	return a->arrival < b->arrival ? -1 : 1;
+    }
+    return a->order - b->order;
+}
+
+//----------------------------------------------------------------------
+// Workload::Launch
+//	Start the jobs that arrive now, in the order they were added,
+//	and schedule an interrupt for the next one to arrive.
+//----------------------------------------------------------------------
+
+void
+Workload::Launch()
+{
+    qsort(jobs, numJobs, sizeof(Job), JobCompare);
+    next = 0;
+    StartDue();
+}
+
+//----------------------------------------------------------------------
+// Workload::CallBack
+//	Interrupt handler: the next jobs have arrived.  Start them, and
+//	if one of them preempted the running thread, switch to it as
+//	soon as we return from the interrupt, not at the next timer
+//	interrupt.
+//----------------------------------------------------------------------
+
+void
+Workload::CallBack()
+{
+    StartDue();
+    if (kernel->currentThread->getPreempt()) {
+	kernel->interrupt->YieldOnReturn();
+    }
+}
+
+//----------------------------------------------------------------------
+// Workload::StartDue
+//	Start every job that has arrived by now, and schedule an
+//	interrupt for the next one, if there is one.
+//----------------------------------------------------------------------
+
+void
+Workload::StartDue()
+{
+    int now = kernel->stats->totalTicks;
+
+    while (next < numJobs && jobs[next].arrival <= now) {
+	Job *job = &jobs[next++];
+
+	DEBUG(dbgThread, "Job " << job->name << " arrives at " << now
+			<< ", priority " << job->priority);
+	kernel->Exec(job->name, job->priority);
+    }
+    if (next < numJobs) {
+	kernel->interrupt->Schedule(this, jobs[next].arrival - now, ArrivalInt);
+    }
+}
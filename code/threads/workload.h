@@ -0,0 +1,87 @@
+// workload.h
+//	Data structures for the user programs a run of Nachos starts,
+//	and when it starts them.
+//
+//	Each job is a program to run, the priority to run it at, and
+//	the tick it arrives at.  Jobs come from "-e" and "-ep" on the
+//	command line (arriving at tick 0), from job files
+//	("-jobs <file>"), and from generators ("-gen"), as many as we
+//	like.  A job file has a line per job:
+//
+//		<program> <priority> <arrival tick>
+//
+//	Blank lines, and lines starting with '#', are ignored.
+//
+//	A generator adds "count" runs of one program, arriving open
+//	loop -- regardless of how the ones before are doing -- at a
+//	mean rate of one per "gap" ticks:
+//
+//		poisson:<count>:<gap>[:<seed>]
+//			arrivals are a Poisson process: the gaps between
+//			them are exponentially distributed
+//		bursty:<count>:<gap>[:<seed>]
+//			arrivals come in bursts of 1 to BurstyMaxBurst
+//			jobs at once, the bursts a Poisson process
+//
+//	The generators have their own random number generator, so
+//	that the seed alone decides the arrivals, whatever "-rs" is.
+//
+//	Jobs arriving at tick 0 are started, in the order they were
+//	added, before Nachos runs anything; the rest are started by
+//	an interrupt at their arrival tick.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include "copyright.h"
+#include "utility.h"
+#include "callback.h"
+
+const int BurstyMaxBurst = 8;	// most jobs in a burst
+
+class Job {
+  public:
+    char *name;			// the program; our own copy
+    int priority;		// to run it at
+    int arrival;		// tick to start it at
+    int order;			// how many jobs were added before it
+};
+
+class Workload : public CallBackObj {
+  public:
+    Workload();			// no jobs yet
+    ~Workload();
+
+    void Add(char *name, int priority, int arrival);
+				// add a job
+    bool ReadJobFile(char *fileName);
+				// add the jobs in a job file; FALSE if
+				// it can't be read
+    bool Generate(char *spec, char *name, int priority);
+				// add the jobs a generator makes; FALSE
+				// if "spec" makes no sense
+    int NumJobs() { return numJobs; }
+    Job *GetJob(int i) { return &jobs[i]; }
+
+    void Launch();		// start the jobs arriving now, and
+				// schedule the rest
+    void CallBack();		// the next jobs have arrived
+
+  private:
+    Job *jobs;			// sorted by arrival, once launched
+    int numJobs;
+    int size;			// number of slots in jobs
+    int next;			// the next job to start
+    unsigned int randomState;	// of the generators' random numbers
+
+    void StartDue();		// start the jobs that have arrived
+    double Uniform();		// a random number in [0, 1)
+    int Exponential(double mean);
+				// a random gap, in ticks
+};
+
+#endif // WORKLOAD_H
@@ -19,7 +19,8 @@
 #include "main.h"
 #include "addrspace.h"
 #include "machine.h"
-#include "noff.h"
+#include "pager.h"
+#include "frametable.h"
 
 //----------------------------------------------------------------------
 // SwapHeader
@@ -79,6 +80,11 @@ AddrSpace::AddrSpace()
 */    
     // zero out the entire address space
   //  bzero(kernel->machine->mainMemory, MemorySize);
+    pageTable = NULL;
+    numPages = 0;
+    executable = NULL;
+    swapSlot = NULL;
+    image = NULL;
 }
 
 //----------------------------------------------------------------------
@@ -88,11 +94,19 @@ AddrSpace::AddrSpace()
 
 AddrSpace::~AddrSpace()
 {
-   for(int i = 0; i < numPages; i++){
-        kernel->usedPhyPage[pageTable[i].physicalPage] = false;
-        kernel->countPhyPage++;
-    }
-   delete pageTable;
+   if (swapSlot != NULL) {		// demand paged
+	kernel->pager->Release(this);
+	delete [] swapSlot;
+	delete executable;
+   } else {
+	for (unsigned int i = 0; i < numPages; i++) {
+	    kernel->frames->Release(pageTable[i].physicalPage);
+	}
+	if (image != NULL) {
+	    kernel->sharedCode->Detach(image);
+	}
+   }
+   delete [] pageTable;
 }
 
 
@@ -139,55 +153,311 @@ AddrSpace::Load(char *fileName)
     numPages = divRoundUp(size, PageSize);
     size = numPages * PageSize;
 
-    ASSERT(numPages <= kernel->countPhyPage);	// check we're not trying
-						// to run anything too big --
-						// at least until we have
-						// virtual memory
+    if (kernel->pager != NULL) {	// demand paging: load nothing yet
+	pageTable = new TranslationEntry[numPages];
+	swapSlot = new int[numPages];
+	for (unsigned int i = 0; i < numPages; i++) {
+	    pageTable[i].virtualPage = i;
+	    pageTable[i].physicalPage = -1;
+	    pageTable[i].valid = FALSE;		// fault on first touch
+	    pageTable[i].use = FALSE;
+	    pageTable[i].dirty = FALSE;
+	    pageTable[i].readOnly = FALSE;
+	    swapSlot[i] = -1;
+	}
+	this->executable = executable;	// to load the pages from
+	this->noffH = noffH;
+	DEBUG(dbgAddr, "Demand paging address space: " << numPages << ", "
+								<< size);
+	return TRUE;
+    }
+
+    this->executable = executable;	// for LoadPage
+    this->noffH = noffH;
+    image = kernel->sharedCode->Attach(fileName, numPages);
     pageTable = new TranslationEntry[numPages];
-    for(unsigned int i = 0, idx = 0; i < numPages; i++) {
-        pageTable[i].virtualPage = i;
-        while(idx < NumPhysPages && kernel->usedPhyPage[idx] == TRUE) idx++;
-        kernel->usedPhyPage[idx] = TRUE;
-        kernel->countPhyPage--;
-	bzero(&kernel->machine->mainMemory[idx * PageSize], PageSize);
-        pageTable[i].physicalPage = idx;
-        pageTable[i].valid = true;
-        pageTable[i].use = false;
-        pageTable[i].dirty = false;
-        pageTable[i].readOnly = false;
+    for (unsigned int i = 0; i < numPages; i++) {
+	int frame;
+
+	pageTable[i].virtualPage = i;
+	pageTable[i].valid = TRUE;
+	pageTable[i].use = FALSE;
+	pageTable[i].dirty = FALSE;
+	pageTable[i].readOnly = FALSE;
+	if (image != NULL && Shareable(i)) {
+	    if (image->frames[i] < 0) {	// the first to run it
+		image->frames[i] = NewFrame();
+		LoadPage(i, &kernel->machine->mainMemory[
+					image->frames[i] * PageSize]);
+		kernel->machine->InvalidateDecoded(image->frames[i] * PageSize,
+								PageSize);
+	    }
+	    frame = image->frames[i];
+	    kernel->frames->Share(frame);
+	    pageTable[i].readOnly = TRUE;	// see CopyOnWrite
+	} else {
+	    frame = NewFrame();
+	    LoadPage(i, &kernel->machine->mainMemory[frame * PageSize]);
+	    kernel->machine->InvalidateDecoded(frame * PageSize, PageSize);
+	}
+	pageTable[i].physicalPage = frame;
     }
+    this->executable = NULL;
 
     DEBUG(dbgAddr, "Initializing address space: " << numPages << ", " << size);
 
-// then, copy in the code and data segments into memory
-// Note: this code assumes that virtual address = physical address
-    if (noffH.code.size > 0) {
-        DEBUG(dbgAddr, "Initializing code segment.");
-	DEBUG(dbgAddr, noffH.code.virtualAddr << ", " << noffH.code.size);
-        executable->ReadAt(
-		&(kernel->machine->mainMemory[pageTable[noffH.code.virtualAddr/PageSize].physicalPage * PageSize + (noffH.code.virtualAddr%PageSize)]), 
-			noffH.code.size, noffH.code.inFileAddr);
-    }
-    if (noffH.initData.size > 0) {
-        DEBUG(dbgAddr, "Initializing data segment.");
-	DEBUG(dbgAddr, noffH.initData.virtualAddr << ", " << noffH.initData.size);
-        executable->ReadAt(
-		&(kernel->machine->mainMemory[pageTable[noffH.initData.virtualAddr/PageSize].physicalPage * PageSize + (noffH.initData.virtualAddr%PageSize)]),
-			noffH.initData.size, noffH.initData.inFileAddr);
-    }
+    delete executable;			// close file
+    return TRUE;			// success
+}
 
+//----------------------------------------------------------------------
+// AddrSpace::LoadPage
+// 	Fill "into" with page "vpn" as the program starts out: the parts
+//	of the code and data segments in the page, read from the
+//	executable, and zeros everywhere else.
+//----------------------------------------------------------------------
+
+void
+AddrSpace::LoadPage(int vpn, char *into)
+{
+    bzero(into, PageSize);
+    LoadSegment(&noffH.code, vpn, into);
+    LoadSegment(&noffH.initData, vpn, into);
 #ifdef RDATA
-    if (noffH.readonlyData.size > 0) {
-        DEBUG(dbgAddr, "Initializing read only data segment.");
-	DEBUG(dbgAddr, noffH.readonlyData.virtualAddr << ", " << noffH.readonlyData.size);
-        executable->ReadAt(
-		&(kernel->machine->mainMemory[pageTable[noffH.readonlyData.virtualAddr/PageSize].physicalPage * PageSize + (noffH.readonlyData.virtualAddr%PageSize)]),
-			noffH.readonlyData.size, noffH.readonlyData.inFileAddr);
+    LoadSegment(&noffH.readonlyData, vpn, into);
+#endif
+}
+
+//----------------------------------------------------------------------
+// AddrSpace::LoadSegment
+// 	Read the part of "segment" that lies in page "vpn", if any, from
+//	the executable into "into", which holds the page.
+//----------------------------------------------------------------------
+
+void
+AddrSpace::LoadSegment(Segment *segment, int vpn, char *into)
+{
+    int pageStart = vpn * PageSize;
+    int start = max(segment->virtualAddr, pageStart);
+    int end = min(segment->virtualAddr + segment->size, pageStart + PageSize);
+
+    if (segment->size > 0 && start < end) {
+	executable->ReadAt(into + (start - pageStart), end - start,
+		segment->inFileAddr + (start - segment->virtualAddr));
     }
+}
+
+//----------------------------------------------------------------------
+// BytesInPage
+// 	Return how many bytes of "segment" lie in page "vpn".
+//----------------------------------------------------------------------
+
+static int
+BytesInPage(Segment *segment, int vpn)
+{
+    int pageStart = vpn * PageSize;
+    int start = max(segment->virtualAddr, pageStart);
+    int end = min(segment->virtualAddr + segment->size, pageStart + PageSize);
+
+    return (segment->size > 0 && start < end) ? end - start : 0;
+}
+
+//----------------------------------------------------------------------
+// AddrSpace::Shareable
+// 	Return TRUE if page "vpn" is the same in every address space
+//	loaded from our executable, at least until it is written: it is
+//	filled by code, read-only data and initialized data, with no
+//	room for uninitialized data or stack (see sharedcode.h).
+//----------------------------------------------------------------------
+
+bool
+AddrSpace::Shareable(int vpn)
+{
+    int filled = BytesInPage(&noffH.code, vpn)
+			+ BytesInPage(&noffH.initData, vpn);
+
+#ifdef RDATA
+    filled += BytesInPage(&noffH.readonlyData, vpn);
 #endif
+    return filled == PageSize;
+}
 
-    delete executable;			// close file
-    return TRUE;			// success
+//----------------------------------------------------------------------
+// AddrSpace::CopyOnWrite
+// 	The program stored to page "vpn", which is read-only.  If it is
+//	a shared page with initialized data, give the program a copy of
+//	its own, that it can write, and return TRUE; the store is run
+//	again.  Otherwise the program really did write to its code or
+//	read-only data; return FALSE.
+//----------------------------------------------------------------------
+
+bool
+AddrSpace::CopyOnWrite(unsigned int vpn)
+{
+    TranslationEntry *entry;
+    char *memory = kernel->machine->mainMemory;
+    int frame;
+
+    if (image == NULL || vpn >= numPages || !pageTable[vpn].readOnly
+		|| BytesInPage(&noffH.initData, vpn) == 0) {
+	return FALSE;
+    }
+    entry = &pageTable[vpn];
+    frame = NewFrame();
+    DEBUG(dbgAddr, "Copying shared page " << vpn << " from frame "
+			<< entry->physicalPage << " to frame " << frame);
+    bcopy(&memory[entry->physicalPage * PageSize],
+			&memory[frame * PageSize], PageSize);
+    kernel->machine->InvalidateDecoded(frame * PageSize, PageSize);
+    kernel->frames->Release(entry->physicalPage);
+    entry->physicalPage = frame;
+    entry->readOnly = FALSE;
+    kernel->machine->FlushTranslations();	// reads went to the old frame
+    return TRUE;
+}
+
+//----------------------------------------------------------------------
+// AddrSpace::PageAt
+// 	Return where in main memory the byte at virtual address "vaddr"
+//	is, so the kernel can read it or, if "writing", write it, on
+//	behalf of the program.  The rest of its page follows it.
+//
+//	We do what the program's own load or store would have: a page
+//	that is not in memory is brought in, a shared page is copied
+//	before it is written (see CopyOnWrite), and the use bit is set,
+//	and the dirty bit if "writing".  Return NULL if the program
+//	would have got an address error, or written a read-only page.
+//
+//	The page may be taken out again as soon as someone else runs,
+//	so use it before anything can wait.
+//----------------------------------------------------------------------
+
+char *
+AddrSpace::PageAt(unsigned int vaddr, bool writing)
+{
+    unsigned int vpn = vaddr / PageSize;
+    TranslationEntry *entry;
+
+    if (vpn >= numPages) {
+	return NULL;
+    }
+    entry = &pageTable[vpn];
+    if (!entry->valid) {
+	if (kernel->pager == NULL) {
+	    return NULL;
+	}
+	kernel->pager->PageIn(this, vpn);
+    }
+    if (writing && entry->readOnly && !CopyOnWrite(vpn)) {
+	return NULL;
+    }
+    entry->use = TRUE;
+    if (writing) {
+	entry->dirty = TRUE;
+    }
+    return &kernel->machine->mainMemory[entry->physicalPage * PageSize
+						+ vaddr % PageSize];
+}
+
+//----------------------------------------------------------------------
+// AddrSpace::CopyIn
+// 	Copy "size" bytes from the program's memory, at "vaddr", into
+//	the kernel buffer "into", a page at a time (see PageAt).
+//----------------------------------------------------------------------
+
+bool
+AddrSpace::CopyIn(unsigned int vaddr, char *into, int size)
+{
+    while (size > 0) {
+	char *from = PageAt(vaddr, FALSE);
+	int n = PageSize - vaddr % PageSize;
+
+	if (from == NULL) {
+	    return FALSE;
+	}
+	if (n > size) {
+	    n = size;
+	}
+	bcopy(from, into, n);
+	vaddr += n;
+	into += n;
+	size -= n;
+    }
+    return TRUE;
+}
+
+//----------------------------------------------------------------------
+// AddrSpace::CopyOut
+// 	Copy "size" bytes from the kernel buffer "from" into the
+//	program's memory, at "vaddr", a page at a time (see PageAt).
+//	Instructions decoded from the bytes we change are thrown away.
+//----------------------------------------------------------------------
+
+bool
+AddrSpace::CopyOut(unsigned int vaddr, char *from, int size)
+{
+    while (size > 0) {
+	char *into = PageAt(vaddr, TRUE);
+	int n = PageSize - vaddr % PageSize;
+
+	if (into == NULL) {
+	    return FALSE;
+	}
+	if (n > size) {
+	    n = size;
+	}
+	bcopy(from, into, n);
+	kernel->machine->InvalidateDecoded(
+				into - kernel->machine->mainMemory, n);
+	vaddr += n;
+	from += n;
+	size -= n;
+    }
+    return TRUE;
+}
+
+//----------------------------------------------------------------------
+// AddrSpace::CopyInString
+// 	Copy the string at "vaddr" in the program's memory into "into",
+//	which holds "maxSize" bytes.  Return FALSE if the string does not
+//	fit, or the program could not have read it.
+//----------------------------------------------------------------------
+
+bool
+AddrSpace::CopyInString(unsigned int vaddr, char *into, int maxSize)
+{
+    char *from = NULL;
+
+    for (int i = 0; i < maxSize; i++, vaddr++) {
+	if (from == NULL || vaddr % PageSize == 0) {
+	    if ((from = PageAt(vaddr, FALSE)) == NULL) {
+		return FALSE;
+	    }
+	}
+	into[i] = *from++;
+	if (into[i] == '\0') {
+	    return TRUE;
+	}
+    }
+    return FALSE;
+}
+
+//----------------------------------------------------------------------
+// AddrSpace::NewFrame
+// 	Return a free frame to put a page in.  Without demand paging,
+//	every page of every program must fit in memory.
+//----------------------------------------------------------------------
+
+int
+AddrSpace::NewFrame()
+{
+    int frame = kernel->frames->Allocate();
+
+    if (frame < 0) {
+	cout << "Out of physical memory\n";
+	ASSERT(FALSE);
+    }
+    return frame;
 }
 
 //----------------------------------------------------------------------
@@ -269,12 +539,16 @@ void AddrSpace::SaveState()
 //	this address space can run.
 //
 //      For now, tell the machine where to find the page table.
+//	The machine keeps decoded instructions by physical page, so
+//	those it has stay good; Load invalidated any in our pages.
 //----------------------------------------------------------------------
 
 void AddrSpace::RestoreState() 
 {
     kernel->machine->pageTable = pageTable;
     kernel->machine->pageTableSize = numPages;
+    kernel->machine->FlushTranslations();	// they were for the
+						// last page table
 }
 
 
@@ -320,7 +594,7 @@ AddrSpace::Translate(unsigned int vaddr, unsigned int *paddr, int isReadWrite)
 
     *paddr = pfn*PageSize + offset;
 
-    ASSERT((*paddr < MemorySize));
+    ASSERT((*paddr < (unsigned) MemorySize));
 
     //cerr << " -- AddrSpace::Translate(): vaddr: " << vaddr <<
     //  ", paddr: " << *paddr << "\n";
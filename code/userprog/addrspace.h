@@ -15,6 +15,8 @@
 
 #include "copyright.h"
 #include "filesys.h"
+#include "noff.h"
+#include "sharedcode.h"
 
 #define UserStackSize		1024 	// increase this as necessary!
 
@@ -39,15 +41,50 @@ class AddrSpace {
     // is 0 for Read, 1 for Write.
     ExceptionType Translate(unsigned int vaddr, unsigned int *paddr, int mode);
 
+    bool CopyOnWrite(unsigned int vpn);	// the program stored to read-only
+					// page "vpn"; copy it if shared
+
+    // Move data between the program's memory and the kernel's, for
+    // system calls.  Each returns FALSE if the program could not have
+    // made the access itself.
+    bool CopyIn(unsigned int vaddr, char *into, int size);
+    bool CopyOut(unsigned int vaddr, char *from, int size);
+    bool CopyInString(unsigned int vaddr, char *into, int maxSize);
+					// up to and including the '\0',
+					// in at most maxSize bytes
+
   private:
     TranslationEntry *pageTable;	// Assume linear page table translation
 					// for now!
     unsigned int numPages;		// Number of pages in the virtual 
 					// address space
 
+    // With demand paging (see pager.h), pages are loaded when they are
+    // first touched, so we keep the executable open.
+    OpenFile *executable;		// the program, NULL if not paging
+    NoffHeader noffH;			// where its segments are; kept
+					// to tell copy-on-write pages
+    int *swapSlot;			// swapSlot[vpn] is where the page
+					// is in the swap area, -1 if it
+					// has never been written there
+    SharedImage *image;			// pages shared with others running
+					// the same program; NULL if none
+
     void InitRegisters();		// Initialize user-level CPU registers,
 					// before jumping to user code
+    void LoadPage(int vpn, char *into);	// Read page "vpn" from the
+					// executable, or zero it
+    void LoadSegment(Segment *segment, int vpn, char *into);
+					// The part of page "vpn" from
+					// "segment", if any
+    bool Shareable(int vpn);		// can page "vpn" be shared?
+    char *PageAt(unsigned int vaddr, bool writing);
+					// where "vaddr" is in main memory,
+					// for the kernel to use
+    static int NewFrame();		// a free frame; there must be one
 
+    friend class Pager;			// manages our page table entries
+					// and swap slots
 };
 
 #endif // ADDRSPACE_H
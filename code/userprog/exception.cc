@@ -25,6 +25,7 @@
 #include "main.h"
 #include "syscall.h"
 #include "ksyscall.h"
+#include "pager.h"
 //----------------------------------------------------------------------
 // ExceptionHandler
 // 	Entry point into the Nachos kernel.  Called when a user program
@@ -48,6 +49,7 @@
 //	is in machine.h.
 //----------------------------------------------------------------------
 typedef int OpenFileId;
+const int MaxUserString = 256;	// longest message or file name we take
 void
 ExceptionHandler(ExceptionType which)
 {
@@ -86,8 +88,11 @@ ExceptionHandler(ExceptionType which)
 		DEBUG(dbgSys, "Message received.\n");
 		val = kernel->machine->ReadRegister(4);
 		{
-		char *msg = &(kernel->machine->mainMemory[val]);
-		cout << msg << endl;
+		char msg[MaxUserString];
+		if (kernel->currentThread->space->CopyInString(val, msg,
+							MaxUserString)) {
+		    cout << msg << endl;
+		}
 		}
 		SysHalt();
 		ASSERTNOTREACHED();
@@ -95,9 +100,13 @@ ExceptionHandler(ExceptionType which)
 	    case SC_Create:
 		val = kernel->machine->ReadRegister(4);
 		{
-		char *filename = &(kernel->machine->mainMemory[val]);
-		//cout << filename << endl;
-		status = SysCreate(filename);
+		char filename[MaxUserString];
+		if (kernel->currentThread->space->CopyInString(val, filename,
+							MaxUserString)) {
+		    status = SysCreate(filename);
+		} else {
+		    status = 0;
+		}
 		kernel->machine->WriteRegister(2, (int) status);
 		}
 		kernel->machine->WriteRegister(PrevPCReg, kernel->machine->ReadRegister(PCReg));
@@ -109,9 +118,13 @@ ExceptionHandler(ExceptionType which)
             case SC_Open:
 		val = kernel->machine->ReadRegister(4);
                 {
-                char *filename = &(kernel->machine->mainMemory[val]);
-                //cout << filename << endl;
-                status = SysOpen(filename);
+                char filename[MaxUserString];
+                if (kernel->currentThread->space->CopyInString(val, filename,
+							MaxUserString)) {
+                    status = SysOpen(filename);
+                } else {
+                    status = -1;
+                }
                 kernel->machine->WriteRegister(2, (int) status);
                 }
                 kernel->machine->WriteRegister(PrevPCReg, kernel->machine->ReadRegister(PCReg));
@@ -123,11 +136,15 @@ ExceptionHandler(ExceptionType which)
 	    case SC_Write:
 		val = kernel->machine->ReadRegister(4);
 		{
-		buffer = &(kernel->machine->mainMemory[val]);
                 size = kernel->machine->ReadRegister(5);
                 OpenFileId id =  kernel->machine->ReadRegister(6);
-                //cout << filename << endl;
-                status = SysWrite(buffer, size, id);
+                buffer = new char[size > 0 ? size : 1];
+                if (kernel->currentThread->space->CopyIn(val, buffer, size)) {
+                    status = SysWrite(buffer, size, id);
+                } else {
+                    status = -1;
+                }
+                delete [] buffer;
                 kernel->machine->WriteRegister(2, (int) status);
                 }
                 kernel->machine->WriteRegister(PrevPCReg, kernel->machine->ReadRegister(PCReg));
@@ -153,12 +170,17 @@ ExceptionHandler(ExceptionType which)
             case SC_Read:
            // cout<<"call exception SC_Read call"<<endl;
             val = kernel->machine->ReadRegister(4);
-            buffer = &(kernel->machine->mainMemory[val]);
             size = kernel->machine->ReadRegister(5);
+            buffer = new char[size > 0 ? size : 1];
             {
                 OpenFileId id = kernel->machine->ReadRegister(6);
                 status = SysRead(buffer,size,id);
             }
+            if (status > 0 && !kernel->currentThread->space->CopyOut(val,
+							buffer, status)) {
+                status = -1;
+            }
+            delete [] buffer;
             kernel->machine->WriteRegister(2,(int)status);
             kernel->machine->WriteRegister(PCReg,kernel->machine->ReadRegister(PCReg));
             kernel->machine->WriteRegister(PCReg, kernel->machine->ReadRegister(PCReg) + 4);
@@ -195,6 +217,13 @@ ExceptionHandler(ExceptionType which)
 			DEBUG(dbgAddr, "Program exit\n");
             		val=kernel->machine->ReadRegister(4);
             		cout << "return value:" << val << endl;
+			{				// remember how our program ran
+			IntStatus oldLevel = kernel->interrupt->SetLevel(IntOff);
+			kernel->burstProfile->Learn(kernel->currentThread);
+			(void) kernel->interrupt->SetLevel(oldLevel);
+			}
+			delete kernel->currentThread->space;	// give back
+			kernel->currentThread->space = NULL;	// its memory
 			kernel->currentThread->Finish();
             break;
       	    default:
@@ -202,6 +231,24 @@ ExceptionHandler(ExceptionType which)
 	    break;
 	}
 	break;
+    case PageFaultException:
+	if (kernel->pager == NULL || kernel->machine->tlb != NULL) {
+	    cerr << "Page fault without demand paging\n";
+	    break;
+	}
+	val = kernel->machine->ReadRegister(BadVAddrReg);
+	DEBUG(dbgAddr, "Page fault at " << val);
+	kernel->pager->PageIn(kernel->currentThread->space,
+						(unsigned) val / PageSize);
+	return;				// run the instruction again
+    case ReadOnlyException:
+	val = kernel->machine->ReadRegister(BadVAddrReg);
+	if (kernel->currentThread->space->CopyOnWrite(
+					(unsigned) val / PageSize)) {
+	    return;			// run the store again
+	}
+	cerr << "Write to read-only page at " << val << "\n";
+	break;
 	default:
 		cerr << "Unexpected user mode exception " << (int)which << "\n";
 		break;
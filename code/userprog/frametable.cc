@@ -0,0 +1,144 @@
+// frametable.cc
+//	Routines to hand out the frames of physical memory (see
+//	frametable.h).
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "debug.h"
+#include "frametable.h"
+
+//----------------------------------------------------------------------
+// FrameTable::FrameTable
+//	Initialize the table: every frame is free.  The stack is filled
+//	so frames come off it lowest first, as they did when memory was
+//	searched from the bottom.
+//
+//	"numFrames" -- the number of frames in physical memory
+//----------------------------------------------------------------------
+
+FrameTable::FrameTable(int numFrames)
+{
+    this->numFrames = numFrames;
+    used = new Bitmap(numFrames);
+    freeFrames = new int[numFrames];
+    position = new int[numFrames];
+    refCount = new int[numFrames];
+    numFree = 0;
+    for (int frame = numFrames - 1; frame >= 0; frame--) {
+	position[frame] = numFree;
+	freeFrames[numFree++] = frame;
+	refCount[frame] = 0;
+    }
+}
+
+//----------------------------------------------------------------------
+// FrameTable::~FrameTable
+//	De-allocate the table.
+//----------------------------------------------------------------------
+
+FrameTable::~FrameTable()
+{
+    delete used;
+    delete [] freeFrames;
+    delete [] position;
+    delete [] refCount;
+}
+
+//----------------------------------------------------------------------
+// FrameTable::Allocate
+//	Return a free frame, with one user, or -1 if memory is full.
+//	The one most recently freed, off the top of the stack.
+//----------------------------------------------------------------------
+
+int
+FrameTable::Allocate()
+{
+    int frame;
+
+    if (numFree == 0) {
+	return -1;
+    }
+    frame = freeFrames[numFree - 1];
+    used->Mark(frame);
+    Take(frame);
+    return frame;
+}
+
+//----------------------------------------------------------------------
+// FrameTable::AllocateRange
+//	Return the first of "count" free frames in a row, each with one
+//	user, or -1 if there is no such run.  The bitmap finds the run,
+//	a word at a time; the frames are then taken off the stack.
+//----------------------------------------------------------------------
+
+int
+FrameTable::AllocateRange(int count)
+{
+    int first;
+
+    if (count > numFree) {
+	return -1;
+    }
+    first = used->FindAndSetRange(count);
+    if (first < 0) {
+	return -1;
+    }
+    for (int frame = first; frame < first + count; frame++) {
+	Take(frame);
+    }
+    return first;
+}
+
+//----------------------------------------------------------------------
+// FrameTable::Share
+//	Another address space is using "frame", which is in use.
+//----------------------------------------------------------------------
+
+void
+FrameTable::Share(int frame)
+{
+    ASSERT(InUse(frame));
+    refCount[frame]++;
+}
+
+//----------------------------------------------------------------------
+// FrameTable::Release
+//	An address space is done with "frame".  If it was the last one,
+//	the frame is free, and goes on top of the stack.  Return TRUE
+//	if so.
+//----------------------------------------------------------------------
+
+bool
+FrameTable::Release(int frame)
+{
+    ASSERT(InUse(frame) && refCount[frame] > 0);
+    if (--refCount[frame] > 0) {
+	return FALSE;
+    }
+    used->Clear(frame);
+    position[frame] = numFree;
+    freeFrames[numFree++] = frame;
+    return TRUE;
+}
+
+//----------------------------------------------------------------------
+// FrameTable::Take
+//	Take "frame", already marked in the bitmap, off the stack of
+//	free frames, giving it one user.  The frame on top of the stack
+//	moves into its place.
+//----------------------------------------------------------------------
+
+void
+FrameTable::Take(int frame)
+{
+    int top = freeFrames[--numFree];
+
+    ASSERT(position[frame] >= 0 && refCount[frame] == 0);
+    freeFrames[position[frame]] = top;
+    position[top] = position[frame];
+    position[frame] = -1;
+    refCount[frame] = 1;
+}
@@ -0,0 +1,57 @@
+// frametable.h
+//	Data structures for handing out the frames of physical memory.
+//
+//	A Bitmap says which frames are in use.  The free frames are
+//	also kept on a stack, so taking one, or giving one back, takes
+//	constant time however big memory is; each free frame remembers
+//	where it is on the stack, so that a frame can be taken from the
+//	middle, as when AllocateRange takes a run of frames found in
+//	the bitmap.
+//
+//	Each frame in use has a count of the address spaces using it,
+//	so a frame can be shared: it is free again once the last of
+//	them lets go.
+//
+//     	NOTE: Mutual exclusion must be provided by the caller.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef FRAMETABLE_H
+#define FRAMETABLE_H
+
+#include "copyright.h"
+#include "bitmap.h"
+
+class FrameTable {
+  public:
+    FrameTable(int numFrames);	// every frame free
+    ~FrameTable();
+
+    int Allocate();		// take a free frame; -1 if there are none
+    int AllocateRange(int count);
+				// take "count" free frames in a row, and
+				// return the first; -1 if there is no run
+				// that long
+    void Share(int frame);	// one more user of "frame"
+    bool Release(int frame);	// one less user of "frame"; TRUE if it
+				// is now free
+
+    bool InUse(int frame) { return used->Test(frame); }
+    int RefCount(int frame) { return refCount[frame]; }
+    int NumFree() { return numFree; }
+
+  private:
+    int numFrames;		// frames in physical memory
+    Bitmap *used;		// which frames are in use
+    int *freeFrames;		// the free frames, as a stack
+    int numFree;		// number of frames on the stack
+    int *position;		// where each free frame is on the
+				// stack; -1 for frames in use
+    int *refCount;		// users of each frame; 0 if free
+
+    void Take(int frame);	// "frame" is no longer free
+};
+
+#endif // FRAMETABLE_H
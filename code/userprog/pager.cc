@@ -0,0 +1,285 @@
+// pager.cc
+//	Routines to bring pages of user programs into memory when they
+//	are touched, and to move them out to the swap area when memory
+//	runs out (see pager.h).
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "main.h"
+#include "pager.h"
+#include "addrspace.h"
+#include "synch.h"
+#include "synchdisk.h"
+#include "frametable.h"
+
+//----------------------------------------------------------------------
+// Pager::Pager
+// 	Initialize the pager: it manages no frames yet, and the swap area
+//	-- the whole simulated disk, in slots of a page each -- is empty.
+//
+//	"policy" -- picks the page to take out when memory is full;
+//		we delete it when we are done
+//----------------------------------------------------------------------
+
+Pager::Pager(ReplacementPolicy *policy)
+{
+    owner = new AddrSpace *[NumPhysPages];
+    ownerPage = new int[NumPhysPages];
+    for (int i = 0; i < NumPhysPages; i++) {
+	owner[i] = NULL;
+	ownerPage[i] = -1;
+    }
+    this->policy = policy;
+    kernel->stats->pagingPolicy = policy->Name();
+    sectorsPerPage = divRoundUp(PageSize, SectorSize);
+    swapMap = new Bitmap(NumSectors / sectorsPerPage);
+    lock = new Lock("pager");
+}
+
+//----------------------------------------------------------------------
+// Pager::~Pager
+// 	De-allocate the pager's data structures.
+//----------------------------------------------------------------------
+
+Pager::~Pager()
+{
+    delete [] owner;
+    delete [] ownerPage;
+    delete policy;
+    delete swapMap;
+    delete lock;
+}
+
+//----------------------------------------------------------------------
+// Pager::PageIn
+// 	Bring page "vpn" of "space" into memory, and make its page table
+//	entry valid.  Called when the running program faulted on it;
+//	the faulting instruction is run again when we return.
+//
+//	We may have to wait for the disk, to write out the page whose
+//	frame we take, and to read this one from the swap area; other
+//	threads run meanwhile, and any page fault they take waits for
+//	this one to be done.
+//----------------------------------------------------------------------
+
+void
+Pager::PageIn(AddrSpace *space, int vpn)
+{
+    TranslationEntry *entry = &space->pageTable[vpn];
+    int frame;
+    char *page;
+
+    lock->Acquire();
+    kernel->stats->numPageFaults++;
+    frame = FindFrame();
+    page = &kernel->machine->mainMemory[frame * PageSize];
+    if (space->swapSlot[vpn] >= 0) {
+	DEBUG(dbgAddr, "Paging in page " << vpn << " from swap slot "
+			<< space->swapSlot[vpn] << " to frame " << frame);
+	ReadSwap(space->swapSlot[vpn], page);
+    } else {
+	DEBUG(dbgAddr, "Loading page " << vpn << " into frame " << frame);
+	space->LoadPage(vpn, page);
+    }
+    kernel->machine->InvalidateDecoded(frame * PageSize, PageSize);
+
+    owner[frame] = space;
+    ownerPage[frame] = vpn;
+    entry->physicalPage = frame;
+    entry->use = TRUE;			// the fault was a use
+    entry->dirty = FALSE;		// the same as its copy on disk
+    entry->valid = TRUE;
+    policy->Loaded(frame, entry);
+    lock->Release();
+}
+
+//----------------------------------------------------------------------
+// Pager::Release
+// 	"space" is going away.  Give back the frames holding its pages,
+//	and the swap slots of those it wrote out.  Waits for any paging
+//	in progress, which may be writing out one of its pages.
+//----------------------------------------------------------------------
+
+void
+Pager::Release(AddrSpace *space)
+{
+    lock->Acquire();
+    for (unsigned int vpn = 0; vpn < space->numPages; vpn++) {
+	if (space->pageTable[vpn].valid) {
+	    FreeFrame(space->pageTable[vpn].physicalPage);
+	    space->pageTable[vpn].valid = FALSE;
+	}
+	if (space->swapSlot[vpn] >= 0) {
+	    swapMap->Clear(space->swapSlot[vpn]);
+	    space->swapSlot[vpn] = -1;
+	}
+    }
+    lock->Release();
+}
+
+//----------------------------------------------------------------------
+// Pager::FindFrame
+// 	Return a frame to bring a page into: a free one, if there is
+//	one, otherwise the one the policy picks, once its page is out.
+//	Then write back any pages the policy wants cleaned.
+//----------------------------------------------------------------------
+
+int
+Pager::FindFrame()
+{
+    int frame;
+
+    frame = kernel->frames->Allocate();
+    if (frame >= 0) {
+	return frame;
+    }
+    frame = policy->Victim();
+    if (frame < 0) {		// every frame belongs to a program
+				// loaded without demand paging
+	cout << "Out of physical memory\n";
+	ASSERT(FALSE);
+    }
+    PageOut(frame);
+    for (int dirty = policy->NextToClean(); dirty >= 0;
+				dirty = policy->NextToClean()) {
+	Clean(dirty);
+    }
+    return frame;
+}
+
+//----------------------------------------------------------------------
+// Pager::PageOut
+// 	Take the page in "frame" out of memory.  If it has changed since
+//	it was brought in, write it to its swap slot first, giving it one
+//	if it has none.  Otherwise its copy on disk -- in the swap area,
+//	or the executable -- is still good.
+//
+//	The page table entry is made invalid first, so that the page can't
+//	change while it is being written: its program faults on it, and
+//	waits for us.
+//----------------------------------------------------------------------
+
+void
+Pager::PageOut(int frame)
+{
+    AddrSpace *space = owner[frame];
+    int vpn = ownerPage[frame];
+    TranslationEntry *entry = &space->pageTable[vpn];
+
+    ASSERT(space != NULL && entry->valid && entry->physicalPage == frame);
+    entry->valid = FALSE;
+    kernel->machine->FlushTranslations();
+    kernel->stats->numPageOuts++;
+    if (entry->dirty) {
+	DEBUG(dbgAddr, "Paging out page " << vpn << " from frame " << frame);
+	WriteBack(space, vpn, &kernel->machine->mainMemory[frame * PageSize]);
+	entry->dirty = FALSE;
+    }
+    owner[frame] = NULL;
+    ownerPage[frame] = -1;
+}
+
+//----------------------------------------------------------------------
+// Pager::Clean
+// 	Write the page in "frame" to its swap slot, if it has changed,
+//	but leave it in memory; the policy asked, so it can be taken out
+//	later without waiting for the disk.
+//
+//	The dirty bit is cleared, and cached translations flushed, before
+//	the page is written, so a store while we wait for the disk sets
+//	it again: the page is written again before it is taken out.
+//----------------------------------------------------------------------
+
+void
+Pager::Clean(int frame)
+{
+    AddrSpace *space = owner[frame];
+    TranslationEntry *entry;
+
+    if (space == NULL) {
+	return;
+    }
+    entry = &space->pageTable[ownerPage[frame]];
+    if (!entry->valid || !entry->dirty) {
+	return;
+    }
+    entry->dirty = FALSE;
+    kernel->machine->FlushTranslations();
+    DEBUG(dbgAddr, "Cleaning page " << ownerPage[frame] << " in frame "
+			<< frame);
+    WriteBack(space, ownerPage[frame],
+			&kernel->machine->mainMemory[frame * PageSize]);
+}
+
+//----------------------------------------------------------------------
+// Pager::WriteBack
+// 	Write page "vpn" of "space", at "from", to its swap slot, giving
+//	it one if it has none.
+//----------------------------------------------------------------------
+
+void
+Pager::WriteBack(AddrSpace *space, int vpn, char *from)
+{
+    if (space->swapSlot[vpn] < 0) {
+	space->swapSlot[vpn] = swapMap->FindAndSet();
+	if (space->swapSlot[vpn] < 0) {
+	    cout << "Swap area is full\n";
+	    ASSERT(FALSE);
+	}
+    }
+    DEBUG(dbgAddr, "Writing page " << vpn << " to swap slot "
+			<< space->swapSlot[vpn]);
+    kernel->stats->numPageWrites++;
+    WriteSwap(space->swapSlot[vpn], from);
+}
+
+//----------------------------------------------------------------------
+// Pager::FreeFrame
+// 	The page in "frame" is no longer needed; make the frame free.
+//----------------------------------------------------------------------
+
+void
+Pager::FreeFrame(int frame)
+{
+    policy->Freed(frame);
+    owner[frame] = NULL;
+    ownerPage[frame] = -1;
+    kernel->frames->Release(frame);
+}
+
+//----------------------------------------------------------------------
+// Pager::ReadSwap
+// Pager::WriteSwap
+// 	Move a page between memory and swap slot "slot", a sector at a
+//	time; we wait until the disk is done.
+//----------------------------------------------------------------------
+
+void
+Pager::ReadSwap(int slot, char *into)
+{
+    char sector[SectorSize];
+
+    for (int i = 0; i < sectorsPerPage; i++) {
+	int offset = i * SectorSize;
+
+	kernel->synchDisk->ReadSector(slot * sectorsPerPage + i, sector);
+	bcopy(sector, into + offset, min(SectorSize, PageSize - offset));
+    }
+}
+
+void
+Pager::WriteSwap(int slot, char *from)
+{
+    char sector[SectorSize];
+
+    for (int i = 0; i < sectorsPerPage; i++) {
+	int offset = i * SectorSize;
+
+	bzero(sector, SectorSize);
+	bcopy(from + offset, sector, min(SectorSize, PageSize - offset));
+	kernel->synchDisk->WriteSector(slot * sectorsPerPage + i, sector);
+    }
+}
@@ -0,0 +1,78 @@
+// pager.h
+//	Data structures for demand paging: which page of which address
+//	space is in each physical page frame, and the swap area on the
+//	simulated disk that pages are written to when memory runs out.
+//
+//	With demand paging ("-vm"), every entry in a program's page table
+//	starts out invalid, and nothing is read in when it is loaded.
+//	The first reference to a page traps with a PageFaultException,
+//	and the pager brings the page in, then the instruction is run
+//	again.  The page goes in a free frame if there is one; otherwise
+//	the replacement policy (see replace.h) picks a page to take out,
+//	and we write that page to the swap area first if it has changed
+//	since it was brought in.  The page is filled from the swap area, if it
+//	has been written there, otherwise from the program's executable
+//	(see AddrSpace::LoadPage).
+//
+//	So a program need not fit in memory, nor do all the programs
+//	running together; pages that are never touched are never read.
+//
+//	The swap area is the whole simulated disk, so demand paging needs
+//	the stub file system.  It doesn't work with the TLB, either:
+//	there, a page fault means a TLB miss.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef PAGER_H
+#define PAGER_H
+
+#include "copyright.h"
+#include "list.h"
+#include "bitmap.h"
+#include "replace.h"
+
+class AddrSpace;
+class Lock;
+
+class Pager {
+  public:
+    Pager(ReplacementPolicy *policy);
+				// no pages in memory, nothing swapped;
+				// "policy" picks pages to take out
+    ~Pager();
+
+    void PageIn(AddrSpace *space, int vpn);
+				// bring page "vpn" of "space" into
+				// memory, after a page fault
+    void Release(AddrSpace *space);
+				// "space" is going away; free its frames
+				// and its pages in the swap area
+    void Tick() { policy->Tick(); }
+				// a timer interrupt
+
+  private:
+    AddrSpace **owner;		// owner[frame] has its page "ownerPage"
+    int *ownerPage;		// in the frame; NULL if we don't manage
+				// the frame
+    ReplacementPolicy *policy;	// which of our pages to take out
+    Bitmap *swapMap;		// which slots of the swap area are used
+    int sectorsPerPage;		// disk sectors in a swap slot
+    Lock *lock;			// one page fault at a time
+
+    int FindFrame();		// a free frame, or one taken from
+				// another page
+    void PageOut(int frame);	// take the page out of "frame"
+    void Clean(int frame);	// write back the page in "frame", if
+				// dirty, but leave it in memory
+    void WriteBack(AddrSpace *space, int vpn, char *from);
+				// write page "vpn" of "space" to its
+				// swap slot
+    void FreeFrame(int frame);	// we no longer need "frame"
+    void ReadSwap(int slot, char *into);
+    void WriteSwap(int slot, char *from);
+				// move a page to or from the swap area
+};
+
+#endif // PAGER_H
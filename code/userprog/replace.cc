@@ -0,0 +1,411 @@
+// replace.cc
+//	Routines to choose which page to take out of memory (see
+//	replace.h).
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "main.h"
+#include "replace.h"
+#include "spec.h"
+
+//----------------------------------------------------------------------
+// ReplacementPolicy::ReplacementPolicy
+//	Initialize a policy; none of the frames are ours yet.
+//
+//	"name" -- which policy this is
+//----------------------------------------------------------------------
+
+ReplacementPolicy::ReplacementPolicy(char *name)
+{
+    this->name = name;
+    numFrames = NumPhysPages;
+    numManaged = 0;
+    entries = new TranslationEntry *[numFrames];
+    for (int i = 0; i < numFrames; i++) {
+	entries[i] = NULL;
+    }
+    cleared = FALSE;
+}
+
+//----------------------------------------------------------------------
+// ReplacementPolicy::~ReplacementPolicy
+//	De-allocate a policy.
+//----------------------------------------------------------------------
+
+ReplacementPolicy::~ReplacementPolicy()
+{
+    delete [] entries;
+}
+
+//----------------------------------------------------------------------
+// ReplacementPolicy::Loaded
+//	The pager just brought the page of "entry" into "frame".
+//----------------------------------------------------------------------
+
+void
+ReplacementPolicy::Loaded(int frame, TranslationEntry *entry)
+{
+    ASSERT(!Managed(frame));
+    entries[frame] = entry;
+    numManaged++;
+    Add(frame);
+}
+
+//----------------------------------------------------------------------
+// ReplacementPolicy::Freed
+//	The page in "frame" went away with its address space.
+//----------------------------------------------------------------------
+
+void
+ReplacementPolicy::Freed(int frame)
+{
+    ASSERT(Managed(frame));
+    Remove(frame);
+    entries[frame] = NULL;
+    numManaged--;
+}
+
+//----------------------------------------------------------------------
+// ReplacementPolicy::Victim
+//	Return the frame whose page the pager should take out, and
+//	forget it: the pager tells us again once a new page is in it.
+//	-1 if none of the frames are ours.
+//----------------------------------------------------------------------
+
+int
+ReplacementPolicy::Victim()
+{
+    int frame;
+
+    if (numManaged == 0) {
+	return -1;
+    }
+    frame = Choose();
+    ASSERT(Managed(frame));
+    Remove(frame);
+    entries[frame] = NULL;
+    numManaged--;
+    FlushIfCleared();
+    return frame;
+}
+
+//----------------------------------------------------------------------
+// ReplacementPolicy::Tick
+//	Called on each timer interrupt, with interrupts off.
+//----------------------------------------------------------------------
+
+void
+ReplacementPolicy::Tick()
+{
+    Age();
+    FlushIfCleared();
+}
+
+//----------------------------------------------------------------------
+// ReplacementPolicy::WasUsed
+//	Clear the use bit of the page in "frame", so we can tell if it
+//	is used again, and return what it was.
+//----------------------------------------------------------------------
+
+bool
+ReplacementPolicy::WasUsed(int frame)
+{
+    TranslationEntry *entry = entries[frame];
+
+    if (!entry->use) {
+	return FALSE;
+    }
+    entry->use = FALSE;
+    cleared = TRUE;
+    return TRUE;
+}
+
+//----------------------------------------------------------------------
+// ReplacementPolicy::FlushIfCleared
+//	If we cleared a use bit, flush the cached translations, so that
+//	the next reference to the page goes through Translate, and sets
+//	the bit again.
+//----------------------------------------------------------------------
+
+void
+ReplacementPolicy::FlushIfCleared()
+{
+    if (cleared) {
+	kernel->machine->FlushTranslations();
+	cleared = FALSE;
+    }
+}
+
+//----------------------------------------------------------------------
+// FIFOPolicy::FIFOPolicy
+// FIFOPolicy::~FIFOPolicy
+//	Keep our frames on a list, in the order their pages came in.
+//----------------------------------------------------------------------
+
+FIFOPolicy::FIFOPolicy() : ReplacementPolicy("fifo")
+{
+    order = new List<int>;
+}
+
+FIFOPolicy::~FIFOPolicy()
+{
+    delete order;
+}
+
+void
+FIFOPolicy::Add(int frame)
+{
+    order->Append(frame);
+}
+
+void
+FIFOPolicy::Remove(int frame)
+{
+    order->Remove(frame);
+}
+
+//----------------------------------------------------------------------
+// FIFOPolicy::Choose
+//	Take the page brought in longest ago, used or not.
+//----------------------------------------------------------------------
+
+int
+FIFOPolicy::Choose()
+{
+    return order->Front();
+}
+
+//----------------------------------------------------------------------
+// ClockPolicy::ClockPolicy
+//	The hand starts at frame 0.
+//----------------------------------------------------------------------
+
+ClockPolicy::ClockPolicy() : ReplacementPolicy("clock")
+{
+    hand = 0;
+}
+
+//----------------------------------------------------------------------
+// ClockPolicy::Choose
+//	Sweep our frames from the hand, giving each page used since we
+//	last passed it a second chance: clear its use bit, and go on.
+//	Take the first page not used.  If all were, we come round to
+//	the first again, with its bit now clear.
+//----------------------------------------------------------------------
+
+int
+ClockPolicy::Choose()
+{
+    for (;;) {
+	int frame = hand;
+
+	hand = (hand + 1) % numFrames;
+	if (Managed(frame) && !WasUsed(frame)) {
+	    return frame;
+	}
+    }
+}
+
+//----------------------------------------------------------------------
+// AgingPolicy::AgingPolicy
+//	Keep a counter of "bits" bits for each frame.
+//----------------------------------------------------------------------
+
+AgingPolicy::AgingPolicy(int bits) : ReplacementPolicy("lru")
+{
+    ASSERT(bits > 0 && bits < 32);
+    this->bits = bits;
+    counter = new unsigned int[numFrames];
+    for (int i = 0; i < numFrames; i++) {
+	counter[i] = 0;
+    }
+    next = 0;
+}
+
+AgingPolicy::~AgingPolicy()
+{
+    delete [] counter;
+}
+
+//----------------------------------------------------------------------
+// AgingPolicy::Add
+//	A page just brought in has no history; its use bit -- set, since
+//	the page fault was a use -- counts for it until the next timer
+//	interrupt.
+//----------------------------------------------------------------------
+
+void
+AgingPolicy::Add(int frame)
+{
+    counter[frame] = 0;
+}
+
+//----------------------------------------------------------------------
+// AgingPolicy::Age
+//	Shift each page's use bit into the top of its counter, and clear
+//	it, so the counter says in which recent intervals it was used.
+//----------------------------------------------------------------------
+
+void
+AgingPolicy::Age()
+{
+    for (int frame = 0; frame < numFrames; frame++) {
+	if (Managed(frame)) {
+	    counter[frame] >>= 1;
+	    if (WasUsed(frame)) {
+		counter[frame] |= 1u << (bits - 1);
+	    }
+	}
+    }
+}
+
+//----------------------------------------------------------------------
+// AgingPolicy::Choose
+//	Take the page used least recently, as near as the counters can
+//	tell: the one with the smallest.  A use bit still set means use
+//	since the last interrupt, more recent than any bit of a counter.
+//----------------------------------------------------------------------
+
+int
+AgingPolicy::Choose()
+{
+    int best = -1;
+    unsigned int bestAge = 0;
+
+    for (int i = 0; i < numFrames; i++) {
+	int frame = (next + i) % numFrames;
+	unsigned int age;
+
+	if (!Managed(frame)) {
+	    continue;
+	}
+	age = counter[frame] | (IsUsed(frame) ? 1u << bits : 0);
+	if (best < 0 || age < bestAge) {
+	    best = frame;
+	    bestAge = age;
+	}
+    }
+    next = (best + 1) % numFrames;
+    return best;
+}
+
+//----------------------------------------------------------------------
+// WSClockPolicy::WSClockPolicy
+//	Pages used within "tau" ticks are in the working set.
+//----------------------------------------------------------------------
+
+WSClockPolicy::WSClockPolicy(int tau) : ReplacementPolicy("wsclock")
+{
+    this->tau = tau;
+    lastUse = new int[numFrames];
+    for (int i = 0; i < numFrames; i++) {
+	lastUse[i] = 0;
+    }
+    hand = 0;
+    toClean = new List<int>;
+}
+
+WSClockPolicy::~WSClockPolicy()
+{
+    delete [] lastUse;
+    delete toClean;
+}
+
+void
+WSClockPolicy::Add(int frame)
+{
+    lastUse[frame] = kernel->stats->totalTicks;
+}
+
+void
+WSClockPolicy::Remove(int frame)
+{
+    if (toClean->IsInList(frame)) {
+	toClean->Remove(frame);
+    }
+}
+
+//----------------------------------------------------------------------
+// WSClockPolicy::Choose
+//	Sweep our frames from the hand.  A page used since we last
+//	passed it is in the working set: note when, clear its use bit,
+//	and go on.  Take the first clean page that has been out of the
+//	working set for "tau" ticks; a dirty one is queued to be written
+//	back instead (see NextToClean), so it can be taken cheaply later.
+//
+//	If a whole sweep finds no such page, every page is in the
+//	working set, or dirty: take the one used longest ago.
+//----------------------------------------------------------------------
+
+int
+WSClockPolicy::Choose()
+{
+    int now = kernel->stats->totalTicks;
+    int oldest = -1;
+
+    for (int i = 0; i < numFrames; i++) {
+	int frame = hand;
+
+	hand = (hand + 1) % numFrames;
+	if (!Managed(frame)) {
+	    continue;
+	}
+	if (WasUsed(frame)) {
+	    lastUse[frame] = now;
+	} else if (now - lastUse[frame] > tau) {
+	    if (!IsDirty(frame)) {
+		return frame;
+	    }
+	    if (!toClean->IsInList(frame)
+			&& toClean->NumInList() < MaxCleaning) {
+		toClean->Append(frame);
+	    }
+	}
+	if (oldest < 0 || lastUse[frame] < lastUse[oldest]) {
+	    oldest = frame;
+	}
+    }
+    return oldest;
+}
+
+//----------------------------------------------------------------------
+// WSClockPolicy::NextToClean
+//	Return a dirty frame queued by Choose, or -1.  It stays ours.
+//----------------------------------------------------------------------
+
+int
+WSClockPolicy::NextToClean()
+{
+    if (toClean->IsEmpty()) {
+	return -1;
+    }
+    return toClean->RemoveFront();
+}
+
+//----------------------------------------------------------------------
+// NewReplacementPolicy
+//	Make the policy described by "spec": a name, optionally
+//	followed by ':' and a parameter (see spec.h).  Return NULL if
+//	there is no policy by that name, or the parameter is bad.
+//----------------------------------------------------------------------
+
+ReplacementPolicy *
+NewReplacementPolicy(char *spec)
+{
+    Spec s(spec);
+    int n;
+
+    if (s.Is("fifo") && s.Param() == NULL) {
+	return new FIFOPolicy();
+    } else if (s.Is("clock") && s.Param() == NULL) {
+	return new ClockPolicy();
+    } else if (s.Is("lru") && s.IntParam(&n, 8, 1, 31)) {
+	return new AgingPolicy(n);			// "n" bits
+    } else if (s.Is("wsclock") && s.IntParam(&n, 1000, 1, NeverDue)) {
+	return new WSClockPolicy(n);			// tau of "n" ticks
+    }
+    return NULL;
+}
@@ -0,0 +1,165 @@
+// replace.h
+//	Data structures for choosing which page to take out of memory,
+//	when a page fault finds no free frame.
+//
+//	The pager tells the policy each time it brings a page into a
+//	frame, and each time a frame is freed; when it needs a frame,
+//	the policy picks one.  The policies go by the use and dirty
+//	bits that Machine::Translate sets in the page table entries;
+//	"-replace <name>[:<parameter>]" picks one:
+//
+//	   fifo		   the page brought in longest ago (the default)
+//	   clock	   second chance: sweep the frames, clearing use
+//			   bits, until we find a page not used since the
+//			   last sweep
+//	   lru[:bits]	   approximate LRU: every timer interrupt, shift
+//			   each page's use bit into an aging counter of
+//			   "bits" bits (default 8); take the page with
+//			   the smallest counter
+//	   wsclock[:tau]   working set clock: as clock, but a page used
+//			   within the last "tau" ticks (default 1000) is
+//			   kept, and a dirty one is written back rather
+//			   than taken, so that next time it is clean
+//
+//	Cached translations skip Translate, and so don't set use bits
+//	(see Machine::CacheTranslation).  So when a policy clears any,
+//	the cache is flushed.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef REPLACE_H
+#define REPLACE_H
+
+#include "copyright.h"
+#include "list.h"
+#include "translate.h"
+
+// The interface for all the policies.  The public routines do the
+// common bookkeeping -- which page table entry is in each frame --
+// and call the protected ones, which a policy overrides.
+
+class ReplacementPolicy {
+  public:
+    ReplacementPolicy(char *name);
+    virtual ~ReplacementPolicy();
+
+    char *Name() { return name; }
+    void Loaded(int frame, TranslationEntry *entry);
+				// "entry"'s page was just brought into
+				// "frame"
+    void Freed(int frame);	// the page in "frame" is gone
+    int Victim();		// the frame to take; it is no longer
+				// ours.  -1 if we have none
+    void Tick();		// a timer interrupt
+    virtual int NextToClean() { return -1; }
+				// a frame whose page should be written
+				// back, though it stays in memory;
+				// -1 if none
+
+  protected:
+    virtual void Add(int frame) {}
+				// "frame" is ours now
+    virtual void Remove(int frame) {}
+				// "frame" isn't ours any more
+    virtual int Choose() = 0;	// pick the frame for Victim
+    virtual void Age() {}	// sample the use bits, on a timer
+				// interrupt
+
+    bool Managed(int frame) { return entries[frame] != NULL; }
+				// does "frame" hold one of our pages?
+    bool IsUsed(int frame) { return entries[frame]->use; }
+    bool WasUsed(int frame);	// clear the use bit of the page in
+				// "frame", and return what it was
+    bool IsDirty(int frame) { return entries[frame]->dirty; }
+
+    int numFrames;		// frames in the machine
+    int numManaged;		// how many are ours
+
+  private:
+    char *name;			// which policy this is, for Statistics
+    TranslationEntry **entries;	// the page in each frame; NULL if
+				// the frame isn't ours
+    bool cleared;		// have we cleared a use bit since the
+				// translations were last flushed?
+
+    void FlushIfCleared();	// flush cached translations, if so
+};
+
+class FIFOPolicy : public ReplacementPolicy {
+  public:
+    FIFOPolicy();
+    ~FIFOPolicy();
+
+  protected:
+    void Add(int frame);
+    void Remove(int frame);
+    int Choose();
+
+  private:
+    List<int> *order;		// our frames, in the order their pages
+				// were brought in
+};
+
+class ClockPolicy : public ReplacementPolicy {
+  public:
+    ClockPolicy();
+
+  protected:
+    int Choose();
+
+  private:
+    int hand;			// the next frame to look at
+};
+
+class AgingPolicy : public ReplacementPolicy {
+  public:
+    AgingPolicy(int bits);
+    ~AgingPolicy();
+
+  protected:
+    void Add(int frame);
+    int Choose();
+    void Age();
+
+  private:
+    int bits;			// width of the counters
+    unsigned int *counter;	// per frame; the use bit at each of
+				// the last "bits" timer interrupts,
+				// the latest in the top bit
+    int next;			// where the next search starts, so
+				// ties don't always go to frame 0
+};
+
+// At most this many pages are queued to be written back at once,
+// by WSClockPolicy, so one page fault doesn't wait for many writes.
+const int MaxCleaning = 4;
+
+class WSClockPolicy : public ReplacementPolicy {
+  public:
+    WSClockPolicy(int tau);
+    ~WSClockPolicy();
+
+    int NextToClean();
+
+  protected:
+    void Add(int frame);
+    void Remove(int frame);
+    int Choose();
+
+  private:
+    int tau;			// ticks a page stays in the working set
+				// after it was last used
+    int *lastUse;		// per frame; when its page was last
+				// seen to be used
+    int hand;			// the next frame to look at
+    List<int> *toClean;		// dirty pages out of the working set,
+				// to be written back
+};
+
+// Make the policy described by "spec" ("clock", "lru:16", ...);
+// NULL if there is no such policy.
+extern ReplacementPolicy *NewReplacementPolicy(char *spec);
+
+#endif // REPLACE_H
@@ -0,0 +1,137 @@
+// sharedcode.cc
+//	Routines to share the pages of a program among the address
+//	spaces running it (see sharedcode.h).
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "main.h"
+#include "sharedcode.h"
+#include "frametable.h"
+
+//----------------------------------------------------------------------
+// SharedImage::SharedImage
+//	Initialize the image of an executable, which will have
+//	"numPages" pages; none of them are read in yet.
+//
+//	"name" -- the executable, as it was opened
+//	"inode", "mtime" -- which file that was, and when it last changed
+//----------------------------------------------------------------------
+
+SharedImage::SharedImage(char *name, long inode, long mtime, int numPages)
+{
+    this->name = new char[strlen(name) + 1];
+    strcpy(this->name, name);
+    this->inode = inode;
+    this->mtime = mtime;
+    this->numPages = numPages;
+    frames = new int[numPages];
+    for (int i = 0; i < numPages; i++) {
+	frames[i] = -1;
+    }
+    numUsers = 0;
+}
+
+//----------------------------------------------------------------------
+// SharedImage::~SharedImage
+//	Let go of the frames read in.  Address spaces still mapping one
+//	hold references of their own.
+//----------------------------------------------------------------------
+
+SharedImage::~SharedImage()
+{
+    for (int i = 0; i < numPages; i++) {
+	if (frames[i] >= 0) {
+	    kernel->frames->Release(frames[i]);
+	}
+    }
+    delete [] frames;
+    delete [] name;
+}
+
+//----------------------------------------------------------------------
+// SharedImage::Is
+//	Return TRUE if this is the image of executable "name", as it is
+//	now.
+//----------------------------------------------------------------------
+
+bool
+SharedImage::Is(char *name, long inode, long mtime)
+{
+    return this->inode == inode && this->mtime == mtime
+		&& strcmp(this->name, name) == 0;
+}
+
+//----------------------------------------------------------------------
+// SharedCode::SharedCode
+// SharedCode::~SharedCode
+//	Initialize, and de-allocate, the images.
+//----------------------------------------------------------------------
+
+SharedCode::SharedCode()
+{
+    images = new List<SharedImage *>;
+}
+
+SharedCode::~SharedCode()
+{
+    while (!images->IsEmpty()) {
+	delete images->RemoveFront();
+    }
+    delete images;
+}
+
+//----------------------------------------------------------------------
+// SharedCode::Attach
+//	An address space is being loaded from executable "name", and
+//	will have "numPages" pages.  Return the image it should share,
+//	counting it as a user: the one already there, if another address
+//	space runs the same file, otherwise a new one, with no pages read
+//	in.  Return NULL if we can't tell which file "name" is.
+//----------------------------------------------------------------------
+
+SharedImage *
+SharedCode::Attach(char *name, int numPages)
+{
+#ifdef FILESYS_STUB
+    ListIterator<SharedImage *> iter(images);
+    SharedImage *image;
+    long inode, mtime;
+
+    if (!FileIdentity(name, &inode, &mtime)) {
+	return NULL;
+    }
+    for (; !iter.IsDone(); iter.Next()) {
+	image = iter.Item();
+	if (image->Is(name, inode, mtime)) {
+	    ASSERT(image->numPages == numPages);
+	    image->numUsers++;
+	    return image;
+	}
+    }
+    image = new SharedImage(name, inode, mtime, numPages);
+    image->numUsers = 1;
+    images->Append(image);
+    return image;
+#else
+    return NULL;		// no way to tell the file has changed
+#endif
+}
+
+//----------------------------------------------------------------------
+// SharedCode::Detach
+//	An address space using "image" is going away.  If it was the
+//	last, the image goes too, giving back its frames.
+//----------------------------------------------------------------------
+
+void
+SharedCode::Detach(SharedImage *image)
+{
+    ASSERT(image->numUsers > 0);
+    if (--image->numUsers == 0) {
+	images->Remove(image);
+	delete image;
+    }
+}
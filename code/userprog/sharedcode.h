@@ -0,0 +1,73 @@
+// sharedcode.h
+//	Data structures to share the pages of a program among all the
+//	address spaces running it.
+//
+//	A page holding nothing but code, read-only data and initialized
+//	data looks the same in every address space loaded from the same
+//	executable, so it is read in once, into a frame all of them map.
+//	They map it read-only.  A page of code or read-only data stays
+//	that way; a page with initialized data is copy-on-write: the
+//	first store to it raises a ReadOnlyException, and the address
+//	space gets a copy of its own (see AddrSpace::CopyOnWrite).  Pages
+//	with uninitialized data or stack are never shared.
+//
+//	An executable is known by its name and by which file that is, and
+//	when it last changed (see FileIdentity), so a program rebuilt while
+//	an old copy runs is read in afresh.  The stub file system is
+//	needed for that; with the real one nothing is shared.  Nor is
+//	anything shared with demand paging, where the pager owns the
+//	frames.
+//
+//	The SharedImage holds a reference to each of its frames (see
+//	FrameTable), so they keep what was read in until the last address
+//	space using the image goes away, even if all of them have copied
+//	a page.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef SHAREDCODE_H
+#define SHAREDCODE_H
+
+#include "copyright.h"
+#include "list.h"
+
+// The shared pages of one executable.
+
+class SharedImage {
+  public:
+    SharedImage(char *name, long inode, long mtime, int numPages);
+				// nothing read in yet
+    ~SharedImage();		// releases the frames
+
+    bool Is(char *name, long inode, long mtime);
+				// is this image of that file?
+
+    int numPages;		// pages in the address space
+    int *frames;		// frames[vpn] holds page "vpn", or -1
+				// if it isn't shared, or not read in yet
+    int numUsers;		// address spaces using the image
+
+  private:
+    char *name;			// the executable
+    long inode;			// which file that was
+    long mtime;			// when it last changed
+};
+
+class SharedCode {
+  public:
+    SharedCode();		// no images yet
+    ~SharedCode();
+
+    SharedImage *Attach(char *name, int numPages);
+				// the image of executable "name", made
+				// if need be; NULL if it can't be shared
+    void Detach(SharedImage *image);
+				// an address space is done with "image"
+
+  private:
+    List<SharedImage *> *images;	// every image in use
+};
+
+#endif // SHAREDCODE_H